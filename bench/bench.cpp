@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "hierarchy.h"
+#include "hydra.h"
+#include "memo.h"
+#include "ord.h"
+#include "pool.h"
+
+// ord_bench [filter]
+// runs every benchmark whose name contains filter and reports the time,
+// pool allocations and global operator new calls per operation
+
+namespace {
+
+size_t news = 0;
+
+}  // namespace
+
+void* operator new (size_t n) {
+    ++news;
+    if (auto* p = std::malloc (n ? n : 1)) return p;
+    throw std::bad_alloc ();
+}
+void operator delete (void* p) noexcept { std::free (p); }
+void operator delete (void* p, size_t) noexcept { std::free (p); }
+
+namespace {
+
+template <class T>
+void keep (const T& x) {
+    asm volatile ("" : : "g"(&x) : "memory");
+}
+
+std::string filter;
+
+// calls f (i) for i = 0, 1, ... in growing batches until a batch takes
+// at least 200 ms, and reports that batch
+template <class F>
+void run (const std::string& name, F f) {
+    if (name.find (filter) == std::string::npos) return;
+
+    for (size_t n = 16;; n *= 2) {
+        auto s0 = ord::thread_pool_stats ();
+        auto n0 = news;
+        auto t0 = std::chrono::steady_clock::now ();
+
+        for (size_t i = 0; i < n; ++i) f (i);
+
+        auto t = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - t0).count ();
+        if (t < 2e8) continue;
+
+        auto s1 = ord::thread_pool_stats ();
+        std::cout << std::left << std::setw (28) << name << std::right << std::fixed << std::setprecision (1)
+                  << std::setw (12) << t / n << " ns/op" << std::setprecision (2) << std::setw (10)
+                  << double (s1.allocations - s0.allocations) / n << " pool/op" << std::setw (10)
+                  << double (news - n0) / n << " new/op" << std::endl;
+        return;
+    }
+}
+
+// every 97th ordinal of the first 25k at bound 10: nested, several terms,
+// and neighbours that share long prefixes
+std::vector<ord::ordinal> sample () {
+    std::vector<ord::ordinal> res;
+    ord::ordinal o;
+    for (size_t i = 0; i < 25000 && o.to_next (10); ++i)
+        if (i % 97 == 0) res.push_back (o);
+
+    return res;
+}
+
+}  // namespace
+
+int main (int argc, char** argv) {
+    if (argc > 1) filter = argv[1];
+
+    auto xs = sample ();
+    auto n = xs.size ();
+    auto at = [&] (size_t i) -> const ord::ordinal& { return xs[i % n]; };
+
+    run ("operator<=>", [&] (size_t i) { keep (at (i) <=> at (i + 1)); });
+    run ("operator==", [&] (size_t i) { keep (at (i) == at (i + 1)); });
+
+    run ("operator+ (const&)", [&] (size_t i) { keep (at (i) + at (i * 7 + 3)); });
+    run ("operator+ (&&)", [&] (size_t i) {
+        ord::ordinal b = at (i * 7 + 3);
+        keep (at (i) + std::move (b));
+    });
+    run ("copy", [&] (size_t i) {
+        ord::ordinal b = at (i * 7 + 3);
+        keep (b);
+    });
+    run ("operator+= (const&)", [&] (size_t i) {
+        auto a = at (i);
+        keep (a += at (i * 7 + 3));
+    });
+    run ("operator+= (&&)", [&] (size_t i) {
+        auto a = at (i);
+        ord::ordinal b = at (i * 7 + 3);
+        keep (a += std::move (b));
+    });
+
+    run ("psi (v)", [&] (size_t i) { keep (ord::psi (at (i))); });
+    run ("psi (id, v)", [&] (size_t i) { keep (ord::psi (at (i * 7 + 3), at (i))); });
+    run ("tpsi", [&] (size_t i) { keep (ord::bench::tpsi (at (i * 7 + 3), at (i))); });
+    run ("boost", [&] (size_t i) { keep (ord::bench::boost (at (i), at (i))); });
+    {
+        ord::memo_scope memo;
+        run ("tpsi (memo)", [&] (size_t i) { keep (ord::bench::tpsi (at (i * 7 + 3), at (i))); });
+        run ("boost (memo)", [&] (size_t i) { keep (ord::bench::boost (at (i), at (i))); });
+    }
+    run ("limit", [&] (size_t i) {
+        auto a = at (i);
+        keep (ord::bench::limit (a));
+    });
+
+    for (size_t bound = 1; bound <= 16; ++bound) {
+        ord::ordinal o;
+        run ("to_next (" + std::to_string (bound) + ")", [&] (size_t) {
+            if (!o.to_next (bound)) o = ord::zero;
+        });
+    }
+
+    run ("dom", [&] (size_t i) { keep (at (i).dom ()); });
+    run ("fs (3)", [&] (size_t i) { keep (at (i).fs (3)); });
+    run ("fast_growing (2)", [&] (size_t i) {
+        ord::evaluator ev ({256});
+        keep (ev.fast_growing (at (i), 2));
+    });
+    run ("hardy (3)", [&] (size_t i) {
+        ord::evaluator ev ({256});
+        keep (ev.hardy (at (i), 3));
+    });
+
+    {
+        // one step of the hydra of epsilon_0, started over when it fills up
+        auto h = ord::hydra::from (ord::psi (ord::Omega));
+        run ("hydra step", [&] (size_t) {
+            if (!h->play (1)) h = ord::hydra::from (ord::psi (ord::Omega));
+        });
+    }
+
+    run ("complexity", [&] (size_t i) { keep (at (i).complexity ()); });
+    run ("hash", [&] (size_t i) { keep (at (i).hash ()); });
+    run ("std", [&] (size_t i) { keep (at (i).std ()); });
+    run ("print", [&] (size_t i) {
+        std::ostringstream ss;
+        ss << at (i);
+        keep (ss);
+    });
+    run ("print latex", [&] (size_t i) {
+        std::ostringstream ss;
+        ss << at (i).std ();
+        keep (ss);
+    });
+
+    return 0;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "ord.h"
+
+namespace ord {
+
+// reaches the private steps of the core for the benchmarks
+struct bench {
+    static ordinal::term tpsi (const ordinal& id, const ordinal& v) { return id.tpsi (v); }
+    static std::optional<ordinal> boost (const ordinal& o, const ordinal& cv) { return o.boost (cv); }
+    static bool limit (ordinal& o) { return o.limit (); }
+    static size_t terms (const ordinal& o) { return o.terms.size (); }
+};
+
+}  // namespace ord
@@ -0,0 +1,111 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "bench.h"
+#include "ord.h"
+
+// ord_scaling [--seconds=S] [--steps=N] [--max-bound=B]
+// runs to_next from zero at every bound from 1 to B (default 16), each in a
+// child process so that its peak RSS is its own, for S seconds (default 1)
+// or N steps, whichever comes first, and prints the results as JSON
+
+namespace {
+
+double seconds = 1;
+size_t max_steps = SIZE_MAX;
+size_t max_bound = 16;
+
+void measure (size_t bound) {
+    using clock = std::chrono::steady_clock;
+
+    // timed: to_next alone
+    ord::ordinal o;
+    size_t steps = 0;
+    bool finished = false;
+    auto t0 = clock::now ();
+    double t = 0;
+    while (!finished && steps < max_steps && t < seconds) {
+        for (size_t i = 0; i < 1024 && steps < max_steps; ++i, ++steps) {
+            if (!o.to_next (bound)) {
+                finished = true;
+                break;
+            }
+        }
+        t = std::chrono::duration<double> (clock::now () - t0).count ();
+    }
+
+    // untimed: the same steps again, spelled out as to_next does them, to
+    // count the limit () iterations and the terms
+    ord::ordinal p;
+    size_t limits = 0, terms = 0, max_terms = 0;
+    for (size_t i = 0; i < steps; ++i) {
+        p += ord::one;
+        while (p.complexity () > bound) {
+            ++limits;
+            if (!ord::bench::limit (p)) break;
+        }
+
+        auto n = ord::bench::terms (p);
+        terms += n;
+        max_terms = std::max (max_terms, n);
+    }
+
+    struct rusage ru;
+    getrusage (RUSAGE_SELF, &ru);
+
+    auto per = [&] (double x) { return steps ? x / steps : 0.0; };
+    std::printf (
+        "    {\"bound\": %zu, \"steps\": %zu, \"seconds\": %.6f, \"steps_per_sec\": %.1f, \"ns_per_step\": %.1f, "
+        "\"limit_per_step\": %.4f, \"avg_terms\": %.4f, \"max_terms\": %zu, \"finished\": %s, \"peak_rss_kb\": %ld}",
+        bound, steps, t, t > 0 ? steps / t : 0.0, per (t * 1e9), per (limits), per (terms), max_terms,
+        finished ? "true" : "false", ru.ru_maxrss);
+    std::fflush (stdout);
+}
+
+}  // namespace
+
+int main (int argc, char** argv) {
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (arg.starts_with ("--seconds=")) {
+                seconds = std::stod (std::string (arg.substr (10)));
+            } else if (arg.starts_with ("--steps=")) {
+                max_steps = std::stoull (std::string (arg.substr (8)));
+            } else if (arg.starts_with ("--max-bound=")) {
+                max_bound = std::stoull (std::string (arg.substr (12)));
+            } else {
+                throw 0;
+            }
+        }
+    } catch (...) {
+        std::fprintf (stderr, "usage: ord_scaling [--seconds=S] [--steps=N] [--max-bound=B]\n");
+        return 1;
+    }
+
+    std::printf ("{\"benchmark\": \"to_next scaling\", \"seconds\": %g, \"max_steps\": %zu, \"results\": [\n", seconds,
+                 max_steps);
+    for (size_t bound = 1; bound <= max_bound; ++bound) {
+        if (bound > 1) std::printf (",\n");
+        std::fflush (stdout);
+
+        if (auto pid = fork (); pid == 0) {
+            measure (bound);
+            _exit (0);
+        } else if (pid > 0) {
+            waitpid (pid, nullptr, 0);
+        } else {
+            measure (bound);
+        }
+    }
+    std::printf ("\n]}\n");
+
+    return 0;
+}
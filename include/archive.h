@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "delta.h"
+#include "ord.h"
+
+namespace ord {
+
+// a recorded stretch of an enumeration, read through mmap:
+//   header    magic version bound count interval nkeys delta_at delta_size keys_at
+//   delta     a delta file (see delta.h) with keyframes every interval steps
+//   keys      nkeys (offset, size) word pairs, then the packed tokens of
+//             every keyframe ordinal, 8-byte aligned
+// Steps are found through the keyframe index of the delta file; ordinals
+// through a binary search over the keyframe tokens, which compare in place
+// in the mapping since packed tokens order like the ordinals they encode.
+// The sequence has to be ascending, as any to_next run is.
+class archive_writer {
+    std::ofstream f;
+    std::optional<delta_writer> dw;
+    std::streamoff delta_at;
+    size_t bound, interval, count;
+    std::vector<uint64_t> keys, tokens;
+
+ public:
+    [[nodiscard]]
+    archive_writer (const std::string&, size_t, size_t = 1024);
+    // finishes the file if finish () was not called
+    ~archive_writer ();
+
+    void write (const ordinal&);
+    // false if any section failed to write, in which case the header is
+    // left zero and the file does not open as an archive
+    [[nodiscard]]
+    bool finish ();
+};
+
+class archive {
+    class membuf;
+
+    const unsigned char* base;
+    size_t len;
+    const uint64_t* header;
+
+    [[nodiscard]]
+    std::span<const uint64_t> key (size_t) const;
+
+ public:
+    class cursor;
+
+    // check good () before use
+    [[nodiscard]]
+    explicit archive (const std::string&);
+    ~archive ();
+
+    archive (const archive&) = delete;
+    archive& operator= (const archive&) = delete;
+
+    [[nodiscard]]
+    bool good () const;
+    [[nodiscard]]
+    size_t bound () const;
+    [[nodiscard]]
+    size_t size () const;
+
+    // a cursor whose next () returns the step-th ordinal; steps past the end
+    // give an empty cursor
+    [[nodiscard]]
+    cursor seek (size_t) const;
+    [[nodiscard]]
+    std::optional<ordinal> at (size_t) const;
+    // the first step whose ordinal is >= o, or size () if there is none
+    [[nodiscard]]
+    size_t lower_bound (const ordinal&) const;
+};
+
+class archive::cursor {
+    struct state;
+
+    std::unique_ptr<state> s;
+
+    friend class archive;
+
+ public:
+    [[nodiscard]]
+    cursor ();
+    cursor (cursor&&) noexcept;
+    cursor& operator= (cursor&&) noexcept;
+    ~cursor ();
+
+    [[nodiscard]]
+    std::optional<ordinal> next ();
+};
+
+}  // namespace ord
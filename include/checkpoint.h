@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "ord.h"
+
+namespace ord {
+
+// the state of a long enumeration run
+struct checkpoint {
+    ordinal o;
+    size_t bound;
+    size_t steps;  // to_next calls since the run started or last seeked
+    size_t ut;     // time units already spent in the current frame
+};
+
+// the file is written next to path, synced and renamed over it, so a crash
+// at any point leaves either the previous checkpoint or the new one
+bool save_checkpoint (const std::string&, const checkpoint&);
+// nullopt for a missing, truncated, corrupted or foreign file
+[[nodiscard]]
+std::optional<checkpoint> load_checkpoint (const std::string&);
+
+}  // namespace ord
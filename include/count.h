@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "ord.h"
+
+namespace ord {
+
+// counts the ordinals of complexity <= bound, zero included, that lie below
+// a target without walking the enumeration.
+//
+// An ordinal below x agrees with x on some prefix of cterms and then goes
+// on with a smaller cterm followed by terms below it, so everything reduces
+// to the generating function of ordinals whose terms are all below a term
+// t. That only depends on how many valid terms below t there are of each
+// complexity < bound, which in turn is a count of pairs {id, v} of smaller
+// complexity. The catch is validity: {id, v} is valid iff v is zero, v is
+// self-bounded (every component below v), or the leading id of v is below
+// id, and self-boundedness is not local to the term structure. So the
+// constructor enumerates every ordinal of complexity < bound once, roughly
+// the square root of the final counts, and indexes it; each query after
+// that takes O (terms * bound * (bound + log)), and per-term results are
+// memoized for the length of the query, so that no query leaves anything
+// behind in a counter kept for the process.
+//
+// Nothing above bound 6 can be counted this way, whatever the count type.
+// The table is built by enumeration: counter (6) indexes the 4449603
+// ordinals of complexity <= 5 in about a minute and 1.3 GB, and counter (7)
+// would have to walk the 19787606781400 of complexity <= 6. The counts
+// themselves roughly square from one bound to the next (45, 2109, 4449603,
+// 19787606781400), so past 6 they outgrow size_t too, those of the bounds
+// 12-16 that long runs use by far. make () refuses bounds above max_bound;
+// runs at those bounds are split by cut_points and positioned by
+// ordinal::seek, neither of which counts.
+class counter {
+    using term = ordinal::term;
+
+    struct level;
+
+    struct term_hash {
+        [[nodiscard]]
+        size_t operator() (const term& t) const {
+            return t.hash ();
+        }
+    };
+
+    size_t bound;
+    std::vector<level> levels;  // levels[k] indexes every ordinal of complexity <= k
+
+    using memo = std::unordered_map<term, std::vector<size_t>, term_hash>;
+
+    [[nodiscard]]
+    size_t terms_upto (const term*, size_t) const;
+    [[nodiscard]]
+    std::vector<size_t> terms_below (const term*, memo&) const;
+    [[nodiscard]]
+    static size_t sums (const std::vector<size_t>&, size_t);
+
+    [[nodiscard]]
+    explicit counter (size_t);
+
+ public:
+    static constexpr size_t max_bound = 6;
+
+    // nullptr for a bound above max_bound
+    [[nodiscard]]
+    static std::unique_ptr<counter> make (size_t);
+    ~counter ();
+
+    [[nodiscard]]
+    size_t total () const;
+    // the number of ordinals of complexity <= bound below x; for x within
+    // the bound this is its index in the enumeration starting at zero
+    [[nodiscard]]
+    size_t below (const ordinal&) const;
+    // the inverse: the ordinal with that index, if the index is below total ()
+    [[nodiscard]]
+    std::optional<ordinal> at (size_t) const;
+};
+
+// index of an ordinal in the enumeration at a bound and back, through a
+// counter built on first use of each bound and kept for the process;
+// nullopt for a bound above counter::max_bound
+[[nodiscard]]
+std::optional<size_t> rank (const ordinal&, size_t);
+[[nodiscard]]
+std::optional<ordinal> unrank (size_t, size_t);
+
+}  // namespace ord
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include "ord.h"
+
+namespace ord {
+
+// a recorded sequence of ordinals. Each one is stored as the change to the
+// previous one's packed tokens, which to_next mostly makes at the very end:
+// how many tokens to drop, then the tokens to append. The end tokens that
+// close a packed ordinal are implied and never stored. Every interval-th
+// record is a keyframe that replaces everything, and a trailing index of
+// keyframe offsets gives random access. All numbers are LEB128 varints
+// except the fixed 64-bit words of the footer:
+//   file   := "ordd" version interval record* 0 index
+//   record := tag << 3 | min (n, 7) [n - 7] token^n
+//   tag    := 1                         keyframe
+//           | dropped + 2
+//   index  := offset^k k count "ordd"
+// so that the common records, a bump or a new unit term, take 2-5 bytes
+class delta_writer {
+    std::streambuf* sb;
+    size_t interval;
+    size_t count;
+    uint64_t offset;  // bytes written so far
+    std::vector<uint64_t> prev, keyframes;
+    bool finished, failed;  // failed: a byte did not reach the stream
+
+    void put_bytes (const char*, size_t);
+    void put (uint64_t);
+    void put_word (uint64_t);
+
+ public:
+    static constexpr uint64_t version = 1;
+
+    [[nodiscard]]
+    explicit delta_writer (std::ostream&, size_t = 1024);
+    // finishes the file if finish () was not called
+    ~delta_writer ();
+
+    void write (const ordinal&);
+    // ends the records and writes the index; false if anything written so
+    // far did not reach the stream
+    [[nodiscard]]
+    bool finish ();
+};
+
+class delta_reader {
+    std::istream& is;
+    std::istream::pos_type base;
+    size_t interval;
+    std::vector<uint64_t> prev, full;  // prev without its closing end tokens
+    bool bad, done;
+
+    bool get (uint64_t&);
+
+ public:
+    [[nodiscard]]
+    explicit delta_reader (std::istream&);
+
+    // the next ordinal, or nullopt at the end of the records or on malformed
+    // input; the two are told apart by failed ()
+    [[nodiscard]]
+    std::optional<ordinal> read ();
+    // positions the reader so that the next read returns the i-th ordinal;
+    // needs a seekable stream and a finished file. On success failed () is
+    // cleared, and an index out of range leaves the reader as it was
+    bool seek (size_t);
+    [[nodiscard]]
+    bool failed () const;
+};
+
+}  // namespace ord
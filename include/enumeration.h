@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+
+#include "ord.h"
+
+namespace ord {
+
+// the ordinals of complexity <= bound in ascending order, zero first, as a
+// lazy input range. The view owns a single ordinal that every increment
+// advances in place with to_next, so a reference from the iterator is only
+// good until the next increment and begin () may be called once, as with
+// std::ranges::istream_view.
+class enumeration : public std::ranges::view_interface<enumeration> {
+    ordinal o;
+    size_t bound;
+    bool done;
+
+ public:
+    class iterator;
+
+    [[nodiscard]]
+    enumeration ();
+    [[nodiscard]]
+    explicit enumeration (size_t);
+    // starts at the least ordinal within the bound that is >= from
+    [[nodiscard]]
+    enumeration (size_t, const ordinal&);
+
+    [[nodiscard]]
+    iterator begin ();
+    [[nodiscard]]
+    std::default_sentinel_t end () const;
+};
+
+class enumeration::iterator {
+    enumeration* e;
+
+ public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type = ordinal;
+    using difference_type = std::ptrdiff_t;
+
+    [[nodiscard]]
+    iterator ();
+    [[nodiscard]]
+    explicit iterator (enumeration*);
+
+    [[nodiscard]]
+    const ordinal& operator* () const;
+    iterator& operator++ ();
+    void operator++ (int);
+
+    [[nodiscard]]
+    bool operator== (std::default_sentinel_t) const;
+};
+
+}  // namespace ord
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "natural.h"
+#include "ord.h"
+
+namespace ord {
+
+// limits of one evaluation, 0 for none
+struct eval_budget {
+    size_t steps = 0;  // fundamental sequence descents and closed forms
+    std::chrono::milliseconds time{0};
+    size_t bits = size_t (1) << 24;   // of any intermediate value
+    size_t terms = size_t (1) << 20;  // of the ordinals held at once, top level
+};
+
+// evaluates the fast-growing hierarchy
+//   f_0 (x) = x + 1, f_a+1 (x) = f_a^x (x), f_l (x) = f_l[x] (x)
+// and the Hardy hierarchy
+//   H_0 (x) = x, H_a+1 (x) = H_a (x + 1), H_l (x) = H_l[x] (x)
+// for countable ordinals, with the fundamental sequences of ordinal::fs.
+// Both run on explicit stacks, so deep descents take no native stack, and
+// an evaluation that runs out of its budget stops with nullopt and error ().
+// The budget is checked between steps, and one step of H can take time
+// that grows with x, as the elements of some sequences do.
+// f remembers the value of every successor (a, x) it passes through, and H
+// that of every query, until clear (), as long as a has a few terms and the
+// value a few bits; the memo is dropped whenever it fills up. Nothing else
+// outlives an evaluation.
+class evaluator {
+    struct key {
+        ordinal a;
+        natural x;
+
+        [[nodiscard]]
+        bool operator== (const key&) const = default;
+    };
+    struct key_hash {
+        [[nodiscard]]
+        size_t operator() (const key&) const;
+    };
+    // f_base+1 (x), waiting for left more applications of f_base
+    struct frame {
+        ordinal base;
+        uint64_t x, left;
+    };
+
+    eval_budget budget;
+    std::unordered_map<key, natural, key_hash> f_memo, h_memo;
+    std::vector<frame> stack;
+    size_t held = 0;  // terms of the bases on the stack
+
+    const char* err = nullptr;
+    size_t count = 0;
+    std::chrono::steady_clock::time_point deadline;
+
+    void start ();
+    [[nodiscard]]
+    bool tick ();
+    [[nodiscard]]
+    bool fits (const natural&);
+    [[nodiscard]]
+    bool holds (const ordinal&);
+    [[nodiscard]]
+    std::optional<natural> descend (const ordinal&, uint64_t);
+    void remember (std::unordered_map<key, natural, key_hash>&, key&&, const natural&);
+
+ public:
+    [[nodiscard]]
+    explicit evaluator (eval_budget = {});
+
+    [[nodiscard]]
+    std::optional<natural> fast_growing (const ordinal&, uint64_t);
+    [[nodiscard]]
+    std::optional<natural> hardy (const ordinal&, uint64_t);
+
+    // why the last evaluation failed, nullptr if it did not
+    [[nodiscard]]
+    const char* error () const;
+    // steps taken by the last evaluation
+    [[nodiscard]]
+    size_t steps () const;
+    void clear ();
+};
+
+}  // namespace ord
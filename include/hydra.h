@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "ord.h"
+
+namespace ord {
+
+// which head is cut next: the end of the path that always takes the last
+// (smallest) child, the first, or a uniformly random one
+enum class hydra_strategy { rightmost, leftmost, random };
+
+struct hydra_config {
+    hydra_strategy strategy = hydra_strategy::rightmost;
+    uint64_t seed = 0;                   // for hydra_strategy::random
+    size_t max_nodes = size_t (1) << 26;  // the root included
+};
+
+// Buchholz's hydra game. Every term psi_k (v) is a node labelled k with a
+// child per term of v, copies counted, below a root for the whole ordinal;
+// labels are the naturals and omega, so ordinals with any other id have no
+// hydra. Step n cuts a head s with parent a:
+//   label 0: s goes, and unless a is the root, n copies of the subtree of
+//            a as it is then are added to the parent of a
+//   u + 1:   below s, take the first node r labelled <= u, the root being
+//            below every label; s is replaced by a copy of the subtree of
+//            r whose root is labelled u and in which s is labelled 0
+//   omega:   s is relabelled n + 1
+// Nodes live in one pool with a free list and refer to each other by
+// index, and every walk runs on an explicit stack, so neither deep nor wide
+// hydras take native stack or an allocation per node.
+class hydra {
+    static constexpr uint32_t nil = UINT32_MAX;
+
+    struct node {
+        uint64_t label;
+        uint32_t parent, first, last, prev, next;
+        uint32_t children;  // fills what would be padding
+    };
+
+    std::vector<node> pool;
+    uint32_t spare = nil;  // free list, through next
+    size_t live = 0, most = 0;
+
+    hydra_config config;
+    std::mt19937_64 rng;
+    uint64_t step = 0;
+    uint32_t cursor = 0;  // the cut path is resumed from here
+    bool stuck = false;
+
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+
+    [[nodiscard]]
+    explicit hydra (const hydra_config&);
+
+    [[nodiscard]]
+    uint32_t make (uint64_t);
+    void release (uint32_t);
+    void append (uint32_t, uint32_t);
+    void unlink (uint32_t);
+
+    [[nodiscard]]
+    uint32_t head ();
+    [[nodiscard]]
+    size_t size (uint32_t);
+    // copies the children of the first node under the second, and returns
+    // the copy of the third, nil if it is not among them
+    uint32_t copy (uint32_t, uint32_t, uint32_t);
+    [[nodiscard]]
+    bool cut ();
+
+ public:
+    static constexpr uint64_t omega_label = UINT64_MAX;
+
+    // nullopt if an id is not a natural or omega, or there are too many nodes
+    [[nodiscard]]
+    static std::optional<hydra> from (const ordinal&, const hydra_config& = {});
+
+    // plays up to n steps, and returns the number played: fewer only when
+    // the hydra dies or the next step would pass max_nodes
+    size_t play (size_t);
+
+    [[nodiscard]]
+    bool dead () const;
+    // the last play stopped because the next step did not fit
+    [[nodiscard]]
+    bool full () const;
+    [[nodiscard]]
+    uint64_t steps () const;
+    [[nodiscard]]
+    size_t nodes () const;
+    [[nodiscard]]
+    size_t peak () const;
+
+    // the ordinal of the current hydra, children read as a natural sum
+    [[nodiscard]]
+    ordinal value () const;
+};
+
+}  // namespace ord
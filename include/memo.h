@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ord {
+
+// counters of the calling thread, monotonically increasing
+struct memo_stats {
+    size_t lookups;    // tpsi and boost calls made under a memo_scope
+    size_t hits;       // of those, answered from the memo
+    size_t evictions;  // entries overwritten by a colliding key
+};
+
+[[nodiscard]]
+memo_stats thread_memo_stats ();
+
+// while a memo_scope lives, the calling thread remembers tpsi and boost
+// results in bounded tables and answers repeated arguments from them; the
+// tables are dropped when the outermost scope ends. The enumeration rarely
+// repeats an argument and runs faster without, so the memo is for callers
+// that do, like repeated descents from one ordinal.
+class memo_scope {
+ public:
+    memo_scope ();
+    ~memo_scope ();
+
+    memo_scope (const memo_scope&) = delete;
+    memo_scope& operator= (const memo_scope&) = delete;
+};
+
+}  // namespace ord
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace ord {
+
+// an arbitrary precision natural number, with just the operations the
+// hierarchies need: increments, products with a word and shifts
+class natural {
+    std::vector<uint64_t> limbs;  // little endian, no zero limb on top
+
+ public:
+    [[nodiscard]]
+    natural () = default;
+    [[nodiscard]]
+    natural (uint64_t);  // NOLINT(runtime/explicit)
+
+    // the value, if it fits in a word
+    [[nodiscard]]
+    std::optional<uint64_t> word () const;
+    [[nodiscard]]
+    size_t bits () const;
+    [[nodiscard]]
+    size_t hash () const;
+
+    natural& operator+= (uint64_t);
+    natural& operator*= (uint64_t);
+    natural& operator<<= (size_t);
+
+    [[nodiscard]]
+    bool operator== (const natural&) const = default;
+    [[nodiscard]]
+    std::strong_ordering operator<=> (const natural&) const;
+
+    friend std::ostream& operator<< (std::ostream&, const natural&);
+};
+
+// in decimal
+std::ostream& operator<< (std::ostream&, const natural&);
+
+}  // namespace ord
@@ -1,17 +1,69 @@
 #pragma once
 
 #include <compare>
+#include <cstddef>
 #include <optional>
 #include <ostream>
+#include <span>
 #include <vector>
 
+#include "pool.h"
+#include "small_vector.h"
+
 namespace ord {
 
+// how the fundamental sequence of an ordinal runs, see ordinal::dom ()
+enum class cofinality { zero, successor, countable, uncountable };
+
 class ordinal {
-    class term;
+    // terms are hash-consed: structurally equal terms share one immutable node,
+    // so copying is a reference count bump and equality is pointer equality
+    class term {
+        struct node;
+
+        node* n;
+
+     public:
+        [[nodiscard]]
+        term (const ordinal&, const ordinal&);
+        [[nodiscard]]
+        term (ordinal&&, ordinal&&);
+
+        term (const term&) noexcept;
+        term (term&&) noexcept;
+
+        term& operator= (const term&) noexcept;
+        term& operator= (term&&) noexcept;
+
+        ~term ();
+
+        [[nodiscard]]
+        const ordinal& id () const;
+        [[nodiscard]]
+        const ordinal& v () const;
+        [[nodiscard]]
+        size_t hash () const;
+        [[nodiscard]]
+        size_t complexity () const;
+
+        bool limit ();
+
+        [[nodiscard]]
+        bool operator== (const term&) const;
+        [[nodiscard]]
+        std::strong_ordering operator<=> (const term&) const;
+    };
 
-    struct cterm;
-    std::vector<cterm> terms;
+    struct cterm {
+        term t;
+        size_t c;
+
+        [[nodiscard]]
+        bool operator== (const cterm&) const = default;
+    };
+
+    small_vector<cterm, 3, pool_allocator<cterm>> terms;
+    size_t cx;
 
  public:
     [[nodiscard]]
@@ -20,10 +72,10 @@ class ordinal {
     ordinal (size_t);  // NOLINT(runtime/explicit)
 
     ordinal (const ordinal&) = default;
-    ordinal (ordinal&&) = default;
+    ordinal (ordinal&&) noexcept;
 
     ordinal& operator= (const ordinal&) = default;
-    ordinal& operator= (ordinal&&) = default;
+    ordinal& operator= (ordinal&&) noexcept;
 
     [[nodiscard]]
     operator bool () const;
@@ -46,44 +98,71 @@ class ordinal {
     friend ordinal psi (const ordinal&, const ordinal&);
     friend ordinal psi (const ordinal&);
 
+    friend struct bench;
+    friend class counter;
+    friend class decoder;
+    friend class encoder;
+    friend class evaluator;
+    friend class hydra;
+    friend class packed;
+    friend class parser;
+    friend class persistent;
+    friend struct reference;
+
     class stdform;
 
     stdform std () const;
 
     [[nodiscard]]
     size_t complexity () const;
+    [[nodiscard]]
+    size_t hash () const;
     bool to_next (size_t);
+    // batched to_next: advances up to out.size () steps, recording each
+    // visited ordinal or its complexity, and returns the number of steps taken
+    size_t to_next (size_t, std::span<ordinal>);
+    size_t to_next (size_t, std::span<size_t>);
+    bool seek (const ordinal&, size_t);
+
+    // fundamental sequences: dom () is 0, 1, omega or some Omega_{mu+1},
+    // and fs (x) is defined for x < dom (); the sequence of a successor is
+    // its predecessor alone, and that of zero is empty
+    [[nodiscard]]
+    ordinal dom () const;
+    [[nodiscard]]
+    cofinality cof () const;
+    [[nodiscard]]
+    ordinal fs (const ordinal&) const;
+    [[nodiscard]]
+    ordinal fs (size_t) const;
 
  private:
     ordinal& operator+= (const term&);
     ordinal& operator+= (term&&);
 
+    // every change to terms goes through these so that cx stays in sync
+    void push (const cterm&);
+    void push (cterm&&);
+    cterm pop ();
+    void bump (size_t);
+
     [[nodiscard]]
-    term tpsi (const ordinal&) const;
+    bool successor () const;
+    // *this <= Omega_id, for a nonzero *this
     [[nodiscard]]
-    std::optional<ordinal> boost (const ordinal&) const;
-
-    bool limit ();
-};
-
-struct ordinal::term {
-    ordinal id, v;
-
-    bool limit ();
+    bool fits (const ordinal&) const;
+    // *this with one copy of its last term removed
+    [[nodiscard]]
+    ordinal prefix () const;
 
- public:
     [[nodiscard]]
-    bool operator== (const term&) const = default;
+    term tpsi (const ordinal&) const;
     [[nodiscard]]
-    std::strong_ordering operator<=> (const term&) const;
-};
-
-struct ordinal::cterm {
-    term t;
-    size_t c;
-
+    std::optional<ordinal> boost (const ordinal&) const;
     [[nodiscard]]
-    bool operator== (const cterm&) const = default;
+    term collapse (const ordinal&) const;
+
+    bool limit ();
 };
 
 extern const ordinal zero;
@@ -97,7 +176,9 @@ class ordinal::stdform {
     class citerm;
     class mterm;
 
-    std::vector<citerm> terms;
+    std::vector<citerm, pool_allocator<citerm>> terms;
+
+    friend class parser;
 
     [[nodiscard]]
     stdform ();
@@ -140,7 +221,7 @@ struct ordinal::stdform::stdterm {
 };
 
 struct ordinal::stdform::iterm {
-    std::vector<mterm> mterms;
+    std::vector<mterm, pool_allocator<mterm>> mterms;
     stdform oe;
 
     [[nodiscard]]
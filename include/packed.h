@@ -0,0 +1,50 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "ord.h"
+
+namespace ord {
+
+// an ordinal flattened into a single preorder token array
+//   ordinal := { 1 id v c } 0
+// the encoding is prefix-free and compares lexicographically word by word
+// exactly like the ordinals it encodes
+class packed {
+    std::vector<uint64_t> words;
+
+ public:
+    static constexpr uint64_t end_token = 0;
+    static constexpr uint64_t term_token = 1;
+
+    [[nodiscard]]
+    packed ();
+    [[nodiscard]]
+    explicit packed (const ordinal&);
+
+    [[nodiscard]]
+    ordinal unpack () const;
+    // for words from outside the process: nullopt unless they are exactly
+    // the packed form of an ordinal in normal form
+    [[nodiscard]]
+    static std::optional<ordinal> unpack (std::span<const uint64_t>);
+
+    [[nodiscard]]
+    const uint64_t* data () const;
+    [[nodiscard]]
+    size_t size () const;
+    [[nodiscard]]
+    size_t hash () const;
+
+    [[nodiscard]]
+    bool operator== (const packed&) const = default;
+    [[nodiscard]]
+    std::strong_ordering operator<=> (const packed&) const;
+};
+
+}  // namespace ord
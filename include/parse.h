@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "ord.h"
+
+namespace ord {
+
+struct parse_error {
+    size_t pos;
+    const char* what;
+};
+
+// reads the p<id>(<v>) form written by operator<< (std::ostream&, const ordinal&);
+// the input must be in normal form, i.e. print back to itself. Both readers
+// reject nesting deeper than 256
+[[nodiscard]]
+std::optional<ordinal> parse (std::string_view, parse_error&);
+[[nodiscard]]
+std::optional<ordinal> parse (std::string_view);
+
+// reads the \psi_{..}\left(..\right) form written for ordinal::stdform
+[[nodiscard]]
+std::optional<ordinal> parse_latex (std::string_view, parse_error&);
+[[nodiscard]]
+std::optional<ordinal> parse_latex (std::string_view);
+
+}  // namespace ord
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+
+#include "ord.h"
+
+namespace ord {
+
+// an ordinal whose cterms form an immutable list shared between versions:
+// copying is O (1), and +=, limit and to_next rebind the handle to a new
+// version that shares every cterm before the changed tail with the old one.
+// Versions can be handed to other threads and read there without locking.
+class persistent {
+    using term = ordinal::term;
+    using cterm = ordinal::cterm;
+
+    struct node;
+
+    // the last cterm, linked towards the first
+    std::shared_ptr<const node> last;
+
+    void push (const cterm&);
+    cterm pop ();
+    void bump (size_t);
+
+    persistent& operator+= (const term&);
+
+ public:
+    [[nodiscard]]
+    persistent ();
+    [[nodiscard]]
+    explicit persistent (const ordinal&);
+
+    [[nodiscard]]
+    ordinal value () const;
+
+    [[nodiscard]]
+    persistent operator+ (const ordinal&) const;
+    persistent& operator+= (const ordinal&);
+
+    [[nodiscard]]
+    size_t complexity () const;
+    bool limit ();
+    bool to_next (size_t);
+    // as ordinal::to_next (size_t, std::span<ordinal>) and its complexity
+    // variant; the versions recorded share their cterms
+    size_t to_next (size_t, std::span<persistent>);
+    size_t to_next (size_t, std::span<size_t>);
+};
+
+}  // namespace ord
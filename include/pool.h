@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ord {
+
+// counters of the calling thread, monotonically increasing
+struct pool_stats {
+    size_t allocations;    // blocks handed out by the pool
+    size_t deallocations;  // blocks given back to the pool
+    size_t system;         // requests that had to reach the system allocator
+};
+
+[[nodiscard]]
+pool_stats thread_pool_stats ();
+
+// small blocks are recycled through per-thread free lists and are never
+// returned to the system, so a warmed-up enumeration stops calling malloc
+[[nodiscard]]
+void* pool_allocate (size_t);
+void pool_deallocate (void*, size_t);
+
+template <class T>
+class pool_allocator {
+ public:
+    using value_type = T;
+
+    pool_allocator () = default;
+    template <class U>
+    pool_allocator (const pool_allocator<U>&) noexcept {}  // NOLINT(runtime/explicit)
+
+    [[nodiscard]]
+    T* allocate (size_t n) {
+        return static_cast<T*> (pool_allocate (n * sizeof (T)));
+    }
+    void deallocate (T* p, size_t n) { pool_deallocate (p, n * sizeof (T)); }
+
+    template <class U>
+    [[nodiscard]]
+    bool operator== (const pool_allocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+}  // namespace ord
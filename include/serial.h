@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include "ord.h"
+
+namespace ord {
+
+// a byte stream of ordinals, every number a LEB128 varint:
+//   stream  := "ordv" version ordinal*
+//   ordinal := n { id v c }^n      terms in preorder, n = 0 for zero
+// so small ordinals take a few bytes: omega is 01 00 01 00 00 01 01
+class encoder {
+    std::streambuf* sb;
+
+    struct frame {
+        const ordinal* o;
+        size_t i;
+        int stage;
+    };
+    std::vector<frame> st;
+
+    void put (uint64_t);
+
+ public:
+    static constexpr uint64_t version = 1;
+
+    // writes the stream header
+    [[nodiscard]]
+    explicit encoder (std::ostream&);
+
+    void write (const ordinal&);
+};
+
+class decoder {
+    std::streambuf* sb;
+    bool bad;
+
+    // kept between reads, so that a warm decoder only allocates the term
+    // nodes that are not already interned
+    struct frame {
+        ordinal o, id;
+        uint64_t left;
+        bool has_id;
+    };
+    std::vector<frame> st;
+
+    bool get (uint64_t&);
+    std::nullopt_t fail ();
+
+ public:
+    // reads and checks the stream header
+    [[nodiscard]]
+    explicit decoder (std::istream&);
+
+    // the next ordinal, or nullopt at the end of the stream or on malformed
+    // input; the two are told apart by failed ()
+    [[nodiscard]]
+    std::optional<ordinal> read ();
+    [[nodiscard]]
+    bool failed () const;
+};
+
+}  // namespace ord
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace ord {
+
+// vector keeping its first N elements inline; only the stateless allocators
+// used in this repo are supported
+template <class T, size_t N, class Alloc = std::allocator<T>>
+class small_vector {
+    static_assert (N > 0);
+
+    T* ptr;
+    uint32_t len, cap;
+    alignas (T) unsigned char buf[N * sizeof (T)];
+
+    [[nodiscard]]
+    T* local () {
+        return reinterpret_cast<T*> (buf);
+    }
+    [[nodiscard]]
+    bool is_local () const {
+        return ptr == reinterpret_cast<const T*> (buf);
+    }
+
+    void release () {
+        std::destroy_n (ptr, len);
+        if (!is_local ()) Alloc ().deallocate (ptr, cap);
+    }
+
+    void steal (small_vector&& o) {
+        if (o.is_local ()) {
+            ptr = local ();
+            cap = N;
+            std::uninitialized_move_n (o.ptr, o.len, ptr);
+            std::destroy_n (o.ptr, o.len);
+        } else {
+            ptr = std::exchange (o.ptr, o.local ());
+            cap = std::exchange (o.cap, N);
+        }
+        len = std::exchange (o.len, 0);
+    }
+
+ public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    small_vector (): ptr (local ()), len (0), cap (N) {}
+
+    small_vector (const small_vector& o): small_vector () {
+        reserve (o.len);
+        std::uninitialized_copy_n (o.ptr, o.len, ptr);
+        len = o.len;
+    }
+    small_vector (small_vector&& o) noexcept { steal (std::move (o)); }
+
+    small_vector& operator= (const small_vector& o) {
+        if (this != &o) {
+            clear ();
+            reserve (o.len);
+            std::uninitialized_copy_n (o.ptr, o.len, ptr);
+            len = o.len;
+        }
+        return *this;
+    }
+    small_vector& operator= (small_vector&& o) noexcept {
+        if (this != &o) {
+            release ();
+            steal (std::move (o));
+        }
+        return *this;
+    }
+
+    ~small_vector () { release (); }
+
+    [[nodiscard]]
+    size_t size () const {
+        return len;
+    }
+    [[nodiscard]]
+    bool empty () const {
+        return !len;
+    }
+
+    [[nodiscard]]
+    iterator begin () {
+        return ptr;
+    }
+    [[nodiscard]]
+    iterator end () {
+        return ptr + len;
+    }
+    [[nodiscard]]
+    const_iterator begin () const {
+        return ptr;
+    }
+    [[nodiscard]]
+    const_iterator end () const {
+        return ptr + len;
+    }
+
+    [[nodiscard]]
+    T& operator[] (size_t i) {
+        return ptr[i];
+    }
+    [[nodiscard]]
+    const T& operator[] (size_t i) const {
+        return ptr[i];
+    }
+    [[nodiscard]]
+    T& back () {
+        return ptr[len - 1];
+    }
+    [[nodiscard]]
+    const T& back () const {
+        return ptr[len - 1];
+    }
+
+    void reserve (size_t n) {
+        if (n <= cap) return;
+
+        auto* p = Alloc ().allocate (n);
+        std::uninitialized_move_n (ptr, len, p);
+        std::destroy_n (ptr, len);
+        if (!is_local ()) Alloc ().deallocate (ptr, cap);
+
+        ptr = p;
+        cap = n;
+    }
+
+    template <class... Args>
+    T& emplace_back (Args&&... args) {
+        if (len < cap) return *::new (ptr + len++) T (std::forward<Args> (args)...);
+
+        // build the new element first: args may refer into the old buffer
+        auto ncap = cap * 2;
+        auto* p = Alloc ().allocate (ncap);
+        ::new (p + len) T (std::forward<Args> (args)...);
+        std::uninitialized_move_n (ptr, len, p);
+        std::destroy_n (ptr, len);
+        if (!is_local ()) Alloc ().deallocate (ptr, cap);
+
+        ptr = p;
+        cap = ncap;
+        return ptr[len++];
+    }
+
+    void push_back (const T& x) { emplace_back (x); }
+    void push_back (T&& x) { emplace_back (std::move (x)); }
+
+    void pop_back () { std::destroy_at (ptr + --len); }
+
+    void clear () {
+        std::destroy_n (ptr, len);
+        len = 0;
+    }
+
+    [[nodiscard]]
+    bool operator== (const small_vector& o) const {
+        return std::equal (begin (), end (), o.begin (), o.end ());
+    }
+};
+
+}  // namespace ord
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+namespace ord {
+
+// counters of the enumeration core, compiled in with -DORD_STATS=ON. Without
+// it every hook below is discarded at compile time and the counters read
+// zero. With ORD_STATS_DUMP set in the environment the totals of all threads
+// are printed to stderr at exit.
+#ifdef ORD_STATS
+inline constexpr bool stats_enabled = true;
+#else
+inline constexpr bool stats_enabled = false;
+#endif
+
+struct core_stats {
+    static constexpr size_t buckets = 16;  // the last bucket also takes everything above
+
+    size_t to_next;
+    size_t limit;        // ordinal::limit calls
+    size_t term_limit;   // term::limit calls
+    size_t tpsi;
+    size_t boost;
+    size_t allocations;  // pool_allocate calls
+    size_t limits_per_step[buckets];   // limit () iterations within one to_next
+    size_t term_limit_depth[buckets];  // nesting of a term::limit call, from 1
+};
+
+// the calling thread
+[[nodiscard]]
+core_stats thread_core_stats ();
+// every thread, running or finished
+[[nodiscard]]
+core_stats all_core_stats ();
+
+std::ostream& operator<< (std::ostream&, const core_stats&);
+
+// the hooks, each only to be called under if constexpr (stats_enabled)
+namespace stats {
+
+void to_next (size_t);
+void limit ();
+void tpsi ();
+void boost ();
+void allocation ();
+void term_limit_enter ();
+void term_limit_exit ();
+
+}  // namespace stats
+
+}  // namespace ord
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ord.h"
+
+namespace ord {
+
+// increasing ordinals of complexity <= bound starting at zero, at most
+// max_cuts of them; [cuts[i], cuts[i + 1]) then partitions the enumeration.
+// The points of a level below bound, with Omega_x for the cut points x of
+// the bound below, keep every interval under 0.1% of it at bounds 5 and 6.
+// Nothing here counts, so they serve every bound, but their balance could
+// only be measured up to 6, where counter stops
+[[nodiscard]]
+std::vector<ordinal> cut_points (size_t bound, size_t max_cuts);
+
+// visits every ordinal of complexity <= bound, zero included, on `threads`
+// workers. Intervals between cut points are handed out dynamically, each is
+// folded into a fresh copy of init, and the per-interval results are merged
+// into the answer strictly in enumeration order as soon as they are ready,
+// so init must be the identity of merge.
+//   fold (T&, const ordinal&), merge (T&, T&&)
+template <class T, class Fold, class Merge>
+[[nodiscard]]
+T parallel_sweep (size_t bound, size_t threads, const T& init, Fold fold, Merge merge) {
+    auto cuts = cut_points (bound, 1 << 16);
+
+    std::vector<std::optional<T>> parts (cuts.size ());
+    std::atomic<size_t> next = 0;
+    std::mutex m;
+    size_t merged = 0;
+    T res = init;
+
+    auto work = [&] {
+        for (size_t i; (i = next.fetch_add (1)) < cuts.size ();) {
+            T acc = init;
+
+            auto o = cuts[i];
+            do {
+                if (i + 1 < cuts.size () && o >= cuts[i + 1]) break;
+                fold (acc, std::as_const (o));
+            } while (o.to_next (bound));
+
+            std::lock_guard l (m);
+            parts[i] = std::move (acc);
+            for (; merged < parts.size () && parts[merged].has_value (); ++merged) {
+                merge (res, std::move (parts[merged].value ()));
+                parts[merged].reset ();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; ++i) pool.emplace_back (work);
+    work ();
+    for (auto& t : pool) t.join ();
+
+    return res;
+}
+
+}  // namespace ord
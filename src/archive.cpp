@@ -0,0 +1,207 @@
+#include "archive.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <istream>
+#include <streambuf>
+
+#include "packed.h"
+
+namespace ord {
+
+namespace {
+
+constexpr uint64_t magic = 0x006863726164726full;  // "ordarch\0" on disk
+constexpr uint64_t version = 1;
+
+// header words
+constexpr size_t h_magic = 0, h_version = 1, h_bound = 2, h_count = 3, h_interval = 4, h_nkeys = 5, h_delta_at = 6,
+                 h_delta_size = 7, h_keys_at = 8, header_words = 9;
+
+}  // namespace
+
+archive_writer::archive_writer (const std::string& path, size_t bound, size_t interval)
+    : f (path, std::ios::binary | std::ios::trunc), bound (bound), interval (std::max<size_t> (interval, 1)), count (0) {
+    uint64_t header[header_words] = {};
+    f.write (reinterpret_cast<const char*> (header), sizeof (header));
+
+    delta_at = f.tellp ();
+    dw.emplace (f, this->interval);
+}
+
+archive_writer::~archive_writer () {
+    if (dw.has_value ()) static_cast<void> (finish ());
+}
+
+void archive_writer::write (const ordinal& o) {
+    if (count++ % interval == 0) {
+        packed p (o);
+        keys.push_back (tokens.size ());
+        keys.push_back (p.size ());
+        tokens.insert (tokens.end (), p.data (), p.data () + p.size ());
+    }
+
+    dw->write (o);
+}
+
+bool archive_writer::finish () {
+    // the header goes last and only over complete sections, so a short
+    // write leaves the zero header, which archive rejects
+    auto ok = dw->finish () && f.good ();
+    dw.reset ();
+
+    std::streamoff end = f.tellp ();
+    uint64_t delta_size = end - delta_at;
+    while (ok && end % sizeof (uint64_t)) {
+        f.put (0);
+        ++end;
+    }
+
+    ok = ok && f.write (reinterpret_cast<const char*> (keys.data ()), keys.size () * sizeof (uint64_t)) &&
+         f.write (reinterpret_cast<const char*> (tokens.data ()), tokens.size () * sizeof (uint64_t)) && f.flush ();
+
+    if (ok) {
+        uint64_t header[header_words] = {magic, version, bound, count, interval, keys.size () / 2, static_cast<uint64_t> (delta_at), delta_size,
+                                         static_cast<uint64_t> (end)};
+        f.seekp (0);
+        ok = static_cast<bool> (f.write (reinterpret_cast<const char*> (header), sizeof (header)));
+    }
+    f.close ();
+
+    return ok && !f.fail ();
+}
+
+// a read-only view of mapped bytes as a seekable stream, so delta_reader
+// decodes straight from the page cache
+class archive::membuf : public std::streambuf {
+ public:
+    membuf (const unsigned char* p, size_t n) {
+        auto* c = reinterpret_cast<char*> (const_cast<unsigned char*> (p));
+        setg (c, c, c + n);
+    }
+
+ protected:
+    pos_type seekoff (off_type off, std::ios::seekdir dir, std::ios::openmode) override {
+        auto* p = (dir == std::ios::beg ? eback () : dir == std::ios::cur ? gptr () : egptr ()) + off;
+        if (p < eback () || p > egptr ()) return pos_type (off_type (-1));
+
+        setg (eback (), p, egptr ());
+        return p - eback ();
+    }
+
+    pos_type seekpos (pos_type pos, std::ios::openmode which) override { return seekoff (pos, std::ios::beg, which); }
+};
+
+struct archive::cursor::state {
+    membuf buf;
+    std::istream is;
+    delta_reader r;
+
+    state (const unsigned char* p, size_t n): buf (p, n), is (&buf), r (is) {}
+};
+
+archive::archive (const std::string& path): base (nullptr), len (0), header (nullptr) {
+    auto fd = open (path.c_str (), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat (fd, &st) == 0 && st.st_size >= static_cast<off_t> (header_words * sizeof (uint64_t))) {
+        len = st.st_size;
+        auto* p = mmap (nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) base = static_cast<const unsigned char*> (p);
+    }
+    close (fd);
+    if (!base) return;
+
+    header = reinterpret_cast<const uint64_t*> (base);
+
+    // every offset has to stay inside the mapping
+    auto words = len / sizeof (uint64_t);
+    auto nkeys = header[h_nkeys], keys_at = header[h_keys_at] / sizeof (uint64_t);
+    auto ok = header[h_magic] == magic && header[h_version] == version && header[h_interval] &&
+              header[h_delta_at] <= len && header[h_delta_size] <= len - header[h_delta_at] &&
+              header[h_keys_at] % sizeof (uint64_t) == 0 && keys_at <= words && nkeys <= (words - keys_at) / 2 &&
+              nkeys == (header[h_count] + header[h_interval] - 1) / header[h_interval];
+
+    for (size_t i = 0; ok && i < nkeys; ++i) {
+        auto ntokens = words - keys_at - 2 * nkeys;
+        const auto* k = header + keys_at + 2 * i;
+        ok = k[0] <= ntokens && k[1] <= ntokens - k[0];
+    }
+
+    if (!ok) {
+        munmap (const_cast<unsigned char*> (base), len);
+        base = nullptr;
+    }
+}
+
+archive::~archive () {
+    if (base) munmap (const_cast<unsigned char*> (base), len);
+}
+
+bool archive::good () const { return base; }
+size_t archive::bound () const { return header[h_bound]; }
+size_t archive::size () const { return good () ? header[h_count] : 0; }
+
+std::span<const uint64_t> archive::key (size_t i) const {
+    const auto* keys = header + header[h_keys_at] / sizeof (uint64_t);
+    const auto* tokens = keys + 2 * header[h_nkeys];
+
+    return {tokens + keys[2 * i], keys[2 * i + 1]};
+}
+
+archive::cursor archive::seek (size_t step) const {
+    cursor res;
+    if (step >= size ()) return res;
+
+    res.s = std::make_unique<cursor::state> (base + header[h_delta_at], header[h_delta_size]);
+    if (!res.s->r.seek (step)) res.s.reset ();
+
+    return res;
+}
+
+std::optional<ordinal> archive::at (size_t step) const { return seek (step).next (); }
+
+size_t archive::lower_bound (const ordinal& o) const {
+    if (!size ()) return 0;
+
+    // keyframes strictly below o, compared in the mapping
+    packed p (o);
+    auto below = [&] (size_t i) {
+        auto k = key (i);
+        return std::lexicographical_compare_three_way (k.begin (), k.end (), p.data (), p.data () + p.size ()) < 0;
+    };
+    size_t lo = 0, hi = header[h_nkeys];
+    while (lo < hi) {
+        auto mid = (lo + hi) / 2;
+        if (below (mid)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (!lo) return 0;
+
+    auto step = (lo - 1) * header[h_interval];
+    auto c = seek (step);
+    for (; auto x = c.next (); ++step)
+        if (x.value () >= o) return step;
+
+    return size ();
+}
+
+archive::cursor::cursor () = default;
+archive::cursor::cursor (cursor&&) noexcept = default;
+archive::cursor& archive::cursor::operator= (cursor&&) noexcept = default;
+archive::cursor::~cursor () = default;
+
+std::optional<ordinal> archive::cursor::next () {
+    if (!s) return {};
+    return s->r.read ();
+}
+
+}  // namespace ord
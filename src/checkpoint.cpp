@@ -0,0 +1,85 @@
+#include "checkpoint.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "packed.h"
+
+namespace ord {
+
+namespace {
+
+// file layout, native 64-bit words:
+//   magic version bound steps ut n <n words of packed (o)> checksum
+constexpr uint64_t magic = 0x74706b6364726f00ull;  // "\0ordckpt"
+constexpr uint64_t version = 1;
+constexpr size_t header_words = 6;
+
+[[nodiscard]]
+uint64_t checksum (const std::vector<uint64_t>& words, size_t n) {
+    uint64_t res = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < n; ++i) {
+        res ^= words[i];
+        res *= 0x100000001b3ull;
+    }
+
+    return res;
+}
+
+}  // namespace
+
+bool save_checkpoint (const std::string& path, const checkpoint& cp) {
+    packed p (cp.o);
+
+    std::vector<uint64_t> words = {magic, version, cp.bound, cp.steps, cp.ut, p.size ()};
+    words.insert (words.end (), p.data (), p.data () + p.size ());
+    words.push_back (checksum (words, words.size ()));
+
+    auto tmp = path + ".tmp";
+    auto* f = std::fopen (tmp.c_str (), "wb");
+    if (!f) return false;
+
+    auto ok = std::fwrite (words.data (), sizeof (uint64_t), words.size (), f) == words.size ();
+    ok = std::fflush (f) == 0 && ok;
+    ok = fsync (fileno (f)) == 0 && ok;
+    ok = std::fclose (f) == 0 && ok;
+    if (!ok || std::rename (tmp.c_str (), path.c_str ())) {
+        std::remove (tmp.c_str ());
+        return false;
+    }
+
+    // make the rename itself durable
+    auto slash = path.find_last_of ('/');
+    auto dir = slash == std::string::npos ? std::string (".") : path.substr (0, slash + 1);
+    if (auto fd = open (dir.c_str (), O_RDONLY | O_DIRECTORY); fd >= 0) {
+        fsync (fd);
+        close (fd);
+    }
+
+    return true;
+}
+
+std::optional<checkpoint> load_checkpoint (const std::string& path) {
+    auto* f = std::fopen (path.c_str (), "rb");
+    if (!f) return {};
+
+    std::vector<uint64_t> words;
+    uint64_t buf[512];
+    for (size_t n; (n = std::fread (buf, sizeof (uint64_t), std::size (buf), f));) words.insert (words.end (), buf, buf + n);
+    std::fclose (f);
+
+    if (words.size () < header_words + 1 || words[0] != magic || words[1] != version) return {};
+    auto n = words[5];
+    if (n != words.size () - header_words - 1 || checksum (words, words.size () - 1) != words.back ()) return {};
+
+    auto o = packed::unpack (std::span (words.data () + header_words, n));
+    if (!o.has_value ()) return {};
+
+    return checkpoint{std::move (o.value ()), words[2], words[3], words[4]};
+}
+
+}  // namespace ord
@@ -0,0 +1,313 @@
+#include "count.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "sweep.h"
+
+namespace ord {
+
+namespace {
+
+// answers "how many of the first q values are below x" over a fixed sequence
+// in O (log of the largest value), one bit level at a time
+class wavelet {
+    struct bits {
+        std::vector<uint64_t> w;
+        std::vector<size_t> ones;  // ones[i]: set bits in w[0, i)
+        size_t zeros;
+
+        [[nodiscard]]
+        size_t rank0 (size_t i) const {
+            auto r = ones[i / 64];
+            if (i % 64) r += std::popcount (w[i / 64] & ((uint64_t (1) << (i % 64)) - 1));
+            return i - r;
+        }
+    };
+
+    std::vector<bits> levels;
+
+ public:
+    wavelet () = default;
+
+    wavelet (std::vector<size_t> a, size_t width) {
+        for (size_t l = 0; l < width; ++l) {
+            auto shift = width - 1 - l;
+            bits b{std::vector<uint64_t> (a.size () / 64 + 1), std::vector<size_t> (a.size () / 64 + 2), 0};
+
+            for (size_t i = 0; i < a.size (); ++i)
+                if (a[i] >> shift & 1) b.w[i / 64] |= uint64_t (1) << (i % 64);
+            for (size_t i = 0; i < b.w.size (); ++i) b.ones[i + 1] = b.ones[i] + std::popcount (b.w[i]);
+            b.zeros = b.rank0 (a.size ());
+
+            std::stable_partition (a.begin (), a.end (), [shift] (size_t x) { return !(x >> shift & 1); });
+            levels.push_back (std::move (b));
+        }
+    }
+
+    [[nodiscard]]
+    size_t count_less (size_t q, size_t x) const {
+        if (x >> levels.size ()) return q;
+
+        size_t res = 0, lo = 0, hi = q;
+        for (size_t l = 0; l < levels.size (); ++l) {
+            const auto& b = levels[l];
+            auto lo0 = b.rank0 (lo), hi0 = b.rank0 (hi);
+
+            if (x >> (levels.size () - 1 - l) & 1) {
+                res += hi0 - lo0;
+                lo = b.zeros + lo - lo0;
+                hi = b.zeros + hi - hi0;
+            } else {
+                lo = lo0;
+                hi = hi0;
+            }
+        }
+
+        return res;
+    }
+};
+
+// nullptr above counter::max_bound. A table can take a minute to build, so
+// the global lock only covers finding the slot of a bound: other bounds are
+// served meanwhile, and callers of the same bound wait on its once_flag
+[[nodiscard]]
+const counter* counter_for (size_t bound) {
+    struct slot {
+        std::once_flag once;
+        std::unique_ptr<counter> c;
+    };
+    static std::mutex m;
+    static std::map<size_t, slot> slots;
+
+    if (bound > counter::max_bound) return nullptr;
+
+    slot* s;
+    {
+        std::lock_guard l (m);
+        s = &slots[bound];
+    }
+    std::call_once (s->once, [&] { s->c = counter::make (bound); });
+
+    return s->c.get ();
+}
+
+[[nodiscard]]
+size_t position (const std::vector<ordinal>& all, const ordinal& o) {
+    return std::lower_bound (all.begin (), all.end (), o) - all.begin ();
+}
+
+}  // namespace
+
+// for {id, v} to be valid, v has to be zero or self-bounded ("free"), or else
+// its leading id has to be below id; the latter are indexed by the position
+// of that leading id
+struct counter::level {
+    std::vector<ordinal> all;    // ascending
+    std::vector<size_t> free;    // free[i]: free ordinals among all[0, i)
+    std::vector<size_t> leads;   // lead positions of the other ones, sorted
+    std::vector<size_t> sums;    // sums[i]: leads[0] + ... + leads[i - 1]
+    wavelet lead_seq;            // the same positions in the order of all
+};
+
+counter::counter (size_t bound): bound (bound), levels (bound) {
+    if (!bound) return;
+
+    using list = std::vector<ordinal>;
+    auto top = parallel_sweep (
+        bound - 1, std::thread::hardware_concurrency (), list (),
+        [] (list& l, const ordinal& o) { l.push_back (o); },
+        [] (list& l, list&& part) { l.insert (l.end (), std::make_move_iterator (part.begin ()), std::make_move_iterator (part.end ())); });
+
+    for (size_t k = 0; k < bound; ++k) {
+        auto& l = levels[k];
+        if (k + 1 == bound) {
+            l.all = std::move (top);
+        } else {
+            std::copy_if (top.begin (), top.end (), std::back_inserter (l.all), [k] (const ordinal& o) { return o.complexity () <= k; });
+        }
+
+        std::vector<size_t> seq;
+        l.free.push_back (0);
+        for (const auto& v : l.all) {
+            auto free = !v || zero.tpsi (v) == term (zero, v);
+            l.free.push_back (l.free.back () + free);
+            if (!free) seq.push_back (position (l.all, v.terms[0].t.id ()));
+        }
+
+        l.leads = seq;
+        std::sort (l.leads.begin (), l.leads.end ());
+        l.sums.push_back (0);
+        for (auto p : l.leads) l.sums.push_back (l.sums.back () + p);
+        l.lead_seq = wavelet (std::move (seq), std::bit_width (l.all.size ()));
+    }
+}
+
+std::unique_ptr<counter> counter::make (size_t bound) {
+    if (bound > max_bound) return nullptr;
+    return std::unique_ptr<counter> (new counter (bound));
+}
+
+counter::~counter () = default;
+
+// valid terms below t (all of them for nullptr) whose id and v both have
+// complexity <= k
+size_t counter::terms_upto (const term* t, size_t k) const {
+    const auto& l = levels[k];
+    auto n = l.all.size ();
+    auto p = t ? position (l.all, t->id ()) : n;
+
+    // {id, v} with id among all[0, p): the free v pair with every id, the
+    // others with the ids past their leading id
+    auto nl = std::lower_bound (l.leads.begin (), l.leads.end (), p) - l.leads.begin ();
+    auto res = p * l.free[n] + nl * p - nl - l.sums[nl];
+
+    // {t.id, v} with v below t.v
+    if (t && t->id ().complexity () <= k) {
+        auto q = position (l.all, t->v ());
+        res += l.free[q] + l.lead_seq.count_less (q - l.free[q], p);
+    }
+
+    return res;
+}
+
+// res[k]: valid terms below t of complexity exactly k, for k < bound
+std::vector<size_t> counter::terms_below (const term* t, memo& seen) const {
+    if (t) {
+        if (auto it = seen.find (*t); it != seen.end ()) return it->second;
+    }
+
+    std::vector<size_t> res (bound);
+    for (size_t k = 0, prev = 0; k < bound; ++k) {
+        auto cur = terms_upto (t, k);
+        res[k] = cur - prev;
+        prev = cur;
+    }
+
+    if (t) seen.emplace (*t, res);
+
+    return res;
+}
+
+// ordinals of complexity <= m made of the terms counted in cnt: each term of
+// complexity k contributes 1 + z^(k+1) / (1 - z) to the generating function
+size_t counter::sums (const std::vector<size_t>& cnt, size_t m) {
+    // binom[i][j] = C (i, j), enough for the (1 - z)^-j expansions
+    std::vector<std::vector<size_t>> binom (2 * m + 1);
+    for (size_t i = 0; i < binom.size (); ++i) {
+        binom[i].assign (i + 1, 1);
+        for (size_t j = 1; j < i; ++j) binom[i][j] = binom[i - 1][j - 1] + binom[i - 1][j];
+    }
+
+    std::vector<size_t> f (m + 1, 0);
+    f[0] = 1;
+
+    for (size_t k = 0; k < cnt.size () && k < m; ++k) {
+        auto n = cnt[k];
+        if (!n) continue;
+
+        // (1 + y)^n with y = z^(k+1) / (1 - z); C (n, j) only matters while
+        // j (k + 1) <= m, where it is itself a count of ordinals and fits
+        std::vector<size_t> g (m + 1, 0);
+        size_t c = 1;
+        for (size_t j = 0; j <= n && j * (k + 1) <= m; ++j) {
+            if (j) c = static_cast<size_t> (static_cast<unsigned __int128> (c) * (n - j + 1) / j);
+            for (size_t i = 0; j * (k + 1) + i <= m; ++i) g[j * (k + 1) + i] += c * (j ? binom[i + j - 1][i] : !i);
+        }
+
+        std::vector<size_t> h (m + 1, 0);
+        for (size_t a = 0; a <= m; ++a)
+            for (size_t b = 0; a + b <= m; ++b) h[a + b] += f[a] * g[b];
+        f = std::move (h);
+    }
+
+    size_t res = 0;
+    for (auto x : f) res += x;
+
+    return res;
+}
+
+size_t counter::total () const {
+    memo seen;
+    return sums (terms_below (nullptr, seen), bound);
+}
+
+size_t counter::below (const ordinal& x) const {
+    memo seen;
+    size_t res = 0, used = 0;
+
+    for (const auto& [t, c] : x.terms) {
+        if (used > bound) break;
+
+        auto m = bound - used;
+        auto cnt = terms_below (&t, seen);
+
+        // stop before t, or continue with t i times, i < c, then smaller terms
+        res += sums (cnt, m);
+        for (size_t i = 1; i < c && t.complexity () + i <= m; ++i) res += sums (cnt, m - t.complexity () - i);
+
+        used += t.complexity () + c;
+    }
+
+    return res;
+}
+
+// mirrors below (): after res itself come the ordinals continuing res with
+// a cterm {t, c}, ordered by t, then c, then the rest
+std::optional<ordinal> counter::at (size_t index) const {
+    if (index >= total ()) return {};
+
+    memo seen;
+    ordinal res;
+    for (auto r = index; r--;) {
+        auto m = bound - res.complexity ();
+        const auto& all = levels[m - 1].all;
+
+        // how many continuations start with a term below {id, v}; this only
+        // grows at valid terms, so the largest pair with at most r of them
+        // is the next term
+        auto skipped = [&] (const ordinal& id, const ordinal& v) {
+            term p (id, v);
+            return sums (terms_below (&p, seen), m) - 1;
+        };
+        auto id = std::partition_point (all.begin (), all.end (), [&] (const ordinal& o) { return skipped (o, zero) <= r; });
+        auto v = std::partition_point (all.begin (), all.end (), [&] (const ordinal& o) { return skipped (id[-1], o) <= r; });
+
+        term t (id[-1], v[-1]);
+        auto cnt = terms_below (&t, seen);
+        r -= sums (cnt, m) - 1;
+
+        size_t c = 1;
+        for (;; ++c) {
+            auto n = sums (cnt, m - t.complexity () - c);
+            if (r < n) break;
+            r -= n;
+        }
+
+        res.push ({std::move (t), c});
+    }
+
+    return res;
+}
+
+std::optional<size_t> rank (const ordinal& o, size_t bound) {
+    auto c = counter_for (bound);
+    if (!c) return {};
+
+    return c->below (o);
+}
+
+std::optional<ordinal> unrank (size_t index, size_t bound) {
+    auto c = counter_for (bound);
+    if (!c) return {};
+
+    return c->at (index);
+}
+
+}  // namespace ord
@@ -0,0 +1,213 @@
+#include "delta.h"
+
+#include <algorithm>
+
+#include "packed.h"
+
+namespace ord {
+
+namespace {
+
+constexpr char magic[] = {'o', 'r', 'd', 'd'};
+constexpr size_t footer_words = 3;  // k, count, magic
+
+[[nodiscard]]
+uint64_t magic_word () {
+    uint64_t res = 0;
+    std::copy (magic, magic + sizeof (magic), reinterpret_cast<char*> (&res));
+    return res;
+}
+
+// the end tokens that complete a packed ordinal cut after a coefficient
+[[nodiscard]]
+size_t open_ordinals (const std::vector<uint64_t>& w) {
+    std::vector<bool> is_id (1, false);
+
+    for (size_t i = 0; i < w.size () && is_id.size (); ++i) {
+        if (w[i] == packed::term_token) {
+            is_id.push_back (true);
+        } else if (is_id.back ()) {
+            is_id.back () = false;
+        } else {
+            is_id.pop_back ();
+            ++i;
+        }
+    }
+
+    return is_id.size ();
+}
+
+}  // namespace
+
+delta_writer::delta_writer (std::ostream& os, size_t interval)
+    : sb (os.rdbuf ()), interval (std::max<size_t> (interval, 1)), count (0), offset (0), finished (false), failed (false) {
+    put_bytes (magic, sizeof (magic));
+    put (version);
+    put (this->interval);
+}
+
+delta_writer::~delta_writer () {
+    if (!finished) static_cast<void> (finish ());
+}
+
+// the stream buffer is written directly, so its failures are collected here
+// rather than in the state of the stream. Nothing is written after one:
+// a filebuf whose overflow failed is not safe to write to again
+void delta_writer::put_bytes (const char* b, size_t n) {
+    if (failed) return;
+    auto put = sb->sputn (b, static_cast<std::streamsize> (n));
+    failed = put != static_cast<std::streamsize> (n);
+    offset += put;
+}
+
+void delta_writer::put (uint64_t x) {
+    char b[10];
+    size_t n = 0;
+    for (; x >= 0x80; x >>= 7) b[n++] = static_cast<char> (x | 0x80);
+    b[n++] = static_cast<char> (x);
+    put_bytes (b, n);
+}
+
+void delta_writer::put_word (uint64_t x) { put_bytes (reinterpret_cast<const char*> (&x), sizeof (x)); }
+
+void delta_writer::write (const ordinal& o) {
+    packed p (o);
+    const auto* w = p.data ();
+    auto n = p.size ();
+    while (n && w[n - 1] == packed::end_token) --n;
+
+    size_t shared = 0;
+    uint64_t tag = 1;
+    if (count++ % interval) {
+        auto lim = std::min (n, prev.size ());
+        while (shared < lim && w[shared] == prev[shared]) ++shared;
+        tag = prev.size () - shared + 2;
+    } else {
+        keyframes.push_back (offset);
+    }
+
+    auto len = n - shared;
+    put (tag << 3 | std::min<size_t> (len, 7));
+    if (len >= 7) put (len - 7);
+    for (auto i = shared; i < n; ++i) put (w[i]);
+
+    prev.assign (w, w + n);
+}
+
+bool delta_writer::finish () {
+    finished = true;
+
+    put (0);
+    for (auto k : keyframes) put_word (k);
+    put_word (keyframes.size ());
+    put_word (count);
+    put_word (magic_word ());
+    failed = failed || sb->pubsync () != 0;
+
+    return !failed;
+}
+
+delta_reader::delta_reader (std::istream& is): is (is), base (is.tellg ()), interval (0), bad (false), done (false) {
+    char head[sizeof (magic)];
+    uint64_t v;
+
+    if (is.rdbuf ()->sgetn (head, sizeof (head)) != sizeof (head) || !std::equal (head, head + sizeof (head), magic) || !get (v) ||
+        v != delta_writer::version || !get (v) || !v) {
+        bad = true;
+        return;
+    }
+    interval = v;
+}
+
+bool delta_reader::get (uint64_t& x) {
+    x = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        auto b = is.rdbuf ()->sbumpc ();
+        if (b == std::streambuf::traits_type::eof ()) return false;
+
+        x |= static_cast<uint64_t> (b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+
+    return false;
+}
+
+std::optional<ordinal> delta_reader::read () {
+    if (bad || done) return {};
+
+    uint64_t head, more = 0;
+    if (!get (head)) {
+        bad = true;
+        return {};
+    }
+    if (!head) {
+        done = true;
+        return {};
+    }
+
+    auto tag = head >> 3;
+    auto dropped = tag == 1 ? prev.size () : tag - 2;
+    auto n = head & 7;
+    if (!tag || dropped > prev.size () || (n == 7 && !get (more))) {
+        bad = true;
+        return {};
+    }
+    n += more;
+
+    prev.resize (prev.size () - dropped);
+    for (uint64_t i = 0, w; i < n; ++i) {
+        if (!get (w)) {
+            bad = true;
+            return {};
+        }
+        prev.push_back (w);
+    }
+
+    full.assign (prev.begin (), prev.end ());
+    full.resize (prev.size () + open_ordinals (prev), packed::end_token);
+
+    auto res = packed::unpack (full);
+    if (!res.has_value ()) bad = true;
+
+    return res;
+}
+
+bool delta_reader::seek (size_t i) {
+    // only a header that failed leaves nothing to seek in
+    if (!interval) return false;
+
+    // a failed seek leaves the reader where it was
+    is.clear ();
+    auto pos = is.tellg ();
+    auto fail = [&] {
+        is.clear ();
+        is.seekg (pos);
+        return false;
+    };
+
+    uint64_t footer[footer_words];
+    if (!is.seekg (-static_cast<std::streamoff> (sizeof (footer)), std::ios::end) ||
+        !is.read (reinterpret_cast<char*> (footer), sizeof (footer)) || footer[2] != magic_word ())
+        return fail ();
+
+    auto k = footer[0];
+    if (i >= footer[1] || i / interval >= k) return fail ();
+
+    uint64_t offset;
+    auto at = -static_cast<std::streamoff> (sizeof (footer) + (k - i / interval) * sizeof (uint64_t));
+    if (!is.seekg (at, std::ios::end) || !is.read (reinterpret_cast<char*> (&offset), sizeof (offset))) return fail ();
+
+    is.seekg (base + static_cast<std::streamoff> (offset));
+    prev.clear ();
+    bad = done = false;
+
+    for (auto skip = i % interval; skip--;) {
+        if (!read ().has_value ()) return false;
+    }
+
+    return true;
+}
+
+bool delta_reader::failed () const { return bad; }
+
+}  // namespace ord
@@ -0,0 +1,25 @@
+#include "enumeration.h"
+
+namespace ord {
+
+enumeration::enumeration (): bound (0), done (false) {}
+enumeration::enumeration (size_t bound): bound (bound), done (false) {}
+enumeration::enumeration (size_t bound, const ordinal& from): bound (bound) { done = !o.seek (from, bound); }
+
+enumeration::iterator enumeration::begin () { return iterator (this); }
+std::default_sentinel_t enumeration::end () const { return std::default_sentinel; }
+
+enumeration::iterator::iterator (): e (nullptr) {}
+enumeration::iterator::iterator (enumeration* e): e (e) {}
+
+const ordinal& enumeration::iterator::operator* () const { return e->o; }
+
+enumeration::iterator& enumeration::iterator::operator++ () {
+    e->done = !e->o.to_next (e->bound);
+    return *this;
+}
+void enumeration::iterator::operator++ (int) { ++*this; }
+
+bool enumeration::iterator::operator== (std::default_sentinel_t) const { return e->done; }
+
+}  // namespace ord
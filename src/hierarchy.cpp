@@ -0,0 +1,219 @@
+#include "hierarchy.h"
+
+#include <limits>
+#include <utility>
+
+namespace ord {
+
+namespace {
+
+// memo entries are kept only for ordinals of at most memo_terms top-level
+// terms and values of at most memo_bits, and the memo is dropped when it
+// reaches memo_entries, which bounds it to a few tens of MB
+constexpr size_t memo_entries = size_t (1) << 14;
+constexpr size_t memo_terms = 16;
+constexpr size_t memo_bits = size_t (1) << 12;
+
+}  // namespace
+
+size_t evaluator::key_hash::operator() (const key& k) const {
+    return k.a.hash () * 0x9e3779b97f4a7c15ull ^ k.x.hash ();
+}
+
+evaluator::evaluator (eval_budget budget) : budget (budget) {}
+
+void evaluator::start () {
+    err = nullptr;
+    count = 0;
+    if (budget.time.count ()) deadline = std::chrono::steady_clock::now () + budget.time;
+}
+
+bool evaluator::tick () {
+    ++count;
+    if (budget.steps && count > budget.steps) {
+        err = "step budget exhausted";
+        return false;
+    }
+    // the clock is slow next to a step, so it is only read now and then
+    if (budget.time.count () && count % 1024 == 0 && std::chrono::steady_clock::now () >= deadline) {
+        err = "time budget exhausted";
+        return false;
+    }
+
+    return true;
+}
+
+bool evaluator::fits (const natural& x) {
+    if (!budget.bits || x.bits () <= budget.bits) return true;
+
+    err = "value too large";
+    return false;
+}
+
+bool evaluator::holds (const ordinal& a) {
+    if (!budget.terms || held + a.terms.size () <= budget.terms) return true;
+
+    err = "term budget exhausted";
+    return false;
+}
+
+void evaluator::remember (std::unordered_map<key, natural, key_hash>& memo, key&& k, const natural& x) {
+    if (k.a.terms.size () > memo_terms || x.bits () > memo_bits) return;
+    if (memo.size () >= memo_entries) memo.clear ();
+
+    memo.insert_or_assign (std::move (k), x);
+}
+
+std::optional<natural> evaluator::fast_growing (const ordinal& alpha, uint64_t n) {
+    start ();
+    if (alpha >= Omega) {
+        err = "ordinal is not countable";
+        return {};
+    }
+
+    auto res = descend (alpha, n);
+    // a failed descent leaves frames behind, and their bases can be large
+    stack.clear ();
+    held = 0;
+
+    return res;
+}
+
+std::optional<natural> evaluator::descend (const ordinal& alpha, uint64_t n) {
+    static const ordinal two = 2;
+
+    ordinal a = alpha;
+    natural x = n;
+    for (;;) {
+        // descend from (a, x) until its value is known: limits are replaced
+        // by their x-th element, and successors wait on a frame for the
+        // value of their first application
+        natural value;
+        for (;;) {
+            if (!tick ()) return {};
+
+            if (!a) {
+                value = std::move (x);
+                value += 1;
+                break;
+            }
+            if (a == one) {
+                value = std::move (x);
+                value <<= 1;
+                break;
+            }
+            if (a == two) {
+                auto w = x.word ();
+                if (!w || (budget.bits && x.bits () + *w > budget.bits)) {
+                    err = "value too large";
+                    return {};
+                }
+                value = std::move (x);
+                value <<= *w;
+                break;
+            }
+
+            auto w = x.word ();
+            if (!w) {
+                err = "value too large";
+                return {};
+            }
+
+            if (a.successor ()) {
+                if (a.terms.size () <= memo_terms) {
+                    if (auto it = f_memo.find ({a, x}); it != f_memo.end ()) {
+                        value = it->second;
+                        break;
+                    }
+                }
+                if (!*w) {
+                    value = 0;
+                    break;
+                }
+
+                auto base = a.prefix ();
+                if (!holds (base)) return {};
+                held += base.terms.size ();
+                a = base;
+                stack.push_back ({std::move (base), *w, *w});
+            } else {
+                // l[x] takes time and space that grow with x, and from x = 3
+                // on it is at least 3, so past that f_l (x) >= f_3 (x) has
+                // more than 2^x bits
+                if (*w >= 64) {
+                    err = "value too large";
+                    return {};
+                }
+                a = a.fs (*w);
+                if (!holds (a)) return {};
+            }
+        }
+        if (!fits (value)) return {};
+
+        // the value is that of the innermost frame's application under way,
+        // and the argument of its next one, if any
+        for (;;) {
+            if (stack.empty ()) return value;
+
+            auto& f = stack.back ();
+            if (--f.left) {
+                a = f.base;
+                x = std::move (value);
+                break;
+            }
+
+            if (f.base.terms.size () < memo_terms) remember (f_memo, {f.base + one, f.x}, value);
+            held -= f.base.terms.size ();
+            stack.pop_back ();
+        }
+    }
+}
+
+std::optional<natural> evaluator::hardy (const ordinal& alpha, uint64_t n) {
+    start ();
+    if (alpha >= Omega) {
+        err = "ordinal is not countable";
+        return {};
+    }
+
+    key query{alpha, n};
+    if (auto it = h_memo.find (query); it != h_memo.end ()) return it->second;
+
+    // every step either drops the finite tail of a successor and adds its
+    // length, or moves to the x-th element of a limit, so the value stays
+    // within a word
+    ordinal a = alpha;
+    uint64_t x = n;
+    while (a) {
+        if (!tick ()) return {};
+
+        if (a.successor ()) {
+            auto c = a.pop ().c;
+            if (c > std::numeric_limits<uint64_t>::max () - x) {
+                err = "value too large";
+                return {};
+            }
+            x += c;
+        } else {
+            a = a.fs (x);
+            if (!holds (a)) return {};
+        }
+    }
+
+    natural res = x;
+    if (!fits (res)) return {};
+    remember (h_memo, std::move (query), res);
+
+    return res;
+}
+
+const char* evaluator::error () const { return err; }
+
+size_t evaluator::steps () const { return count; }
+
+void evaluator::clear () {
+    f_memo.clear ();
+    h_memo.clear ();
+}
+
+}  // namespace ord
@@ -0,0 +1,262 @@
+#include "hydra.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace ord {
+
+hydra::hydra (const hydra_config& config) : config (config), rng (config.seed) {
+    // the root, always pool[0]; its label is never read
+    static_cast<void> (make (0));
+}
+
+uint32_t hydra::make (uint64_t label) {
+    uint32_t i;
+    if (spare != nil) {
+        i = spare;
+        spare = pool[i].next;
+    } else {
+        i = pool.size ();
+        pool.emplace_back ();
+    }
+    pool[i] = {label, nil, nil, nil, nil, nil, 0};
+    most = std::max (most, ++live);
+
+    return i;
+}
+
+void hydra::release (uint32_t i) {
+    pool[i].next = spare;
+    spare = i;
+    --live;
+}
+
+void hydra::append (uint32_t p, uint32_t c) {
+    auto& n = pool[c];
+    n.parent = p;
+    n.prev = pool[p].last;
+    n.next = nil;
+
+    if (pool[p].last != nil)
+        pool[pool[p].last].next = c;
+    else
+        pool[p].first = c;
+    pool[p].last = c;
+    ++pool[p].children;
+}
+
+void hydra::unlink (uint32_t c) {
+    auto& n = pool[c];
+    (n.prev != nil ? pool[n.prev].next : pool[n.parent].first) = n.next;
+    (n.next != nil ? pool[n.next].prev : pool[n.parent].last) = n.prev;
+    --pool[n.parent].children;
+}
+
+uint32_t hydra::head () {
+    auto x = config.strategy == hydra_strategy::random ? 0 : cursor;
+    while (pool[x].first != nil) {
+        switch (config.strategy) {
+            case hydra_strategy::rightmost:
+                x = pool[x].last;
+                break;
+            case hydra_strategy::leftmost:
+                x = pool[x].first;
+                break;
+            case hydra_strategy::random: {
+                // walked to from the nearer end of the list
+                uint32_t k = pool[x].children, i = rng () % k;
+                if (i < k / 2) {
+                    for (x = pool[x].first; i > 0; --i) x = pool[x].next;
+                } else {
+                    for (x = pool[x].last; ++i < k;) x = pool[x].prev;
+                }
+                break;
+            }
+        }
+    }
+
+    return x;
+}
+
+size_t hydra::size (uint32_t r) {
+    // preorder through the links, so no stack at all
+    size_t res = 1;
+    for (auto x = r;;) {
+        if (pool[x].first != nil) {
+            x = pool[x].first;
+            ++res;
+            continue;
+        }
+        while (x != r && pool[x].next == nil) x = pool[x].parent;
+        if (x == r) return res;
+        x = pool[x].next;
+        ++res;
+    }
+}
+
+uint32_t hydra::copy (uint32_t from, uint32_t to, uint32_t mark) {
+    uint32_t res = nil;
+
+    // children are pushed last first, so that their copies keep the order
+    stack.clear ();
+    for (auto c = pool[from].last; c != nil; c = pool[c].prev) stack.emplace_back (c, to);
+    while (stack.size ()) {
+        auto [x, p] = stack.back ();
+        stack.pop_back ();
+
+        auto y = make (pool[x].label);
+        append (p, y);
+        if (x == mark) res = y;
+
+        for (auto c = pool[x].last; c != nil; c = pool[c].prev) stack.emplace_back (c, y);
+    }
+
+    return res;
+}
+
+bool hydra::cut () {
+    // only the cut path changes, so the next head lies below the deepest
+    // node of it that survives; the random walk starts over anyway
+    auto s = head ();
+    auto a = pool[s].parent;
+    auto n = step + 1;
+    auto room = std::min (config.max_nodes, size_t (nil)) - live;
+
+    if (pool[s].label == omega_label) {
+        pool[s].label = n + 1;
+        cursor = s;
+    } else if (pool[s].label > 0) {
+        auto u = pool[s].label - 1;
+        auto r = a;
+        while (r != 0 && pool[r].label > u) r = pool[r].parent;
+
+        // the copy is built apart, s being inside what is copied
+        if (size (r) > room) return false;
+        auto t = make (u);
+        auto mark = copy (r, t, s);
+        pool[mark].label = 0;
+
+        for (auto c = pool[t].first; c != nil; c = pool[c].next) pool[c].parent = s;
+        pool[s].first = pool[t].first;
+        pool[s].last = pool[t].last;
+        pool[s].children = pool[t].children;
+        pool[s].label = u;
+        release (t);
+        cursor = s;
+    } else if (a == 0) {
+        unlink (s);
+        release (s);
+        cursor = 0;
+    } else {
+        auto k = size (a) - 1;
+        if (n > (room + 1) / k) return false;
+
+        unlink (s);
+        release (s);
+        auto b = pool[a].parent;
+        for (uint64_t i = 0; i < n; ++i) {
+            auto y = make (pool[a].label);
+            append (b, y);
+            static_cast<void> (copy (a, y, nil));
+        }
+        cursor = b;
+    }
+
+    ++step;
+    return true;
+}
+
+std::optional<hydra> hydra::from (const ordinal& o, const hydra_config& config) {
+    hydra res (config);
+    auto limit = std::min (config.max_nodes, size_t (nil));
+
+    // each v below the node it hangs from
+    std::vector<std::pair<const ordinal*, uint32_t>> todo{{&o, 0}};
+    while (todo.size ()) {
+        auto [v, p] = todo.back ();
+        todo.pop_back ();
+
+        for (const auto& [t, c] : v->terms) {
+            const auto& id = t.id ();
+            uint64_t label;
+            if (!id)
+                label = 0;
+            else if (id == omega)
+                label = omega_label;
+            else if (id < omega)
+                label = id.terms[0].c;
+            else
+                return {};
+
+            if (c > limit - res.live) return {};
+            for (size_t i = 0; i < c; ++i) {
+                auto n = res.make (label);
+                res.append (p, n);
+                todo.emplace_back (&t.v (), n);
+            }
+        }
+    }
+
+    return res;
+}
+
+size_t hydra::play (size_t n) {
+    stuck = false;
+
+    size_t res = 0;
+    for (; res < n && !dead (); ++res) {
+        if (!cut ()) {
+            stuck = true;
+            break;
+        }
+    }
+
+    return res;
+}
+
+bool hydra::dead () const { return pool[0].first == nil; }
+
+bool hydra::full () const { return stuck; }
+
+uint64_t hydra::steps () const { return step; }
+
+size_t hydra::nodes () const { return live; }
+
+size_t hydra::peak () const { return most; }
+
+ordinal hydra::value () const {
+    // postorder through the links: the values of the finished children of
+    // every node on the path wait in vals from the mark of that node on
+    std::vector<ordinal> vals;
+    std::vector<size_t> marks;
+
+    for (uint32_t x = 0;;) {
+        marks.push_back (vals.size ());
+        if (pool[x].first != nil) {
+            x = pool[x].first;
+            continue;
+        }
+
+        for (;;) {
+            auto from = vals.begin () + marks.back ();
+            std::sort (from, vals.end (), std::greater<> ());
+            ordinal v;
+            for (auto it = from; it != vals.end (); ++it) v += std::move (*it);
+            vals.erase (from, vals.end ());
+            marks.pop_back ();
+
+            if (x == 0) return v;
+
+            auto label = pool[x].label;
+            vals.push_back (psi (label == omega_label ? omega : ordinal (label), v));
+
+            if (pool[x].next != nil) {
+                x = pool[x].next;
+                break;
+            }
+            x = pool[x].parent;
+        }
+    }
+}
+
+}  // namespace ord
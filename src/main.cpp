@@ -2,45 +2,92 @@
 #include <condition_variable>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <shared_mutex>
 #include <sstream>
+#include <string_view>
 #include <thread>
 
+#include "checkpoint.h"
 #include "httplib.h"
 #include "ord.h"
+#include "parse.h"
+#include "persistent.h"
 
 class animation {
-    ord::ordinal o;
+    // o belongs to the animation thread and seek, which publish it to
+    // readers once per frame; readers never take m
+    ord::persistent o;
     std::shared_mutex m;
+    std::atomic<std::shared_ptr<const ord::persistent>> shown;
 
     size_t bound;
+    size_t steps = 0;
+
+    // steps enumerated ahead of o in one batch, taken one per wait; a frame
+    // rarely fits more than one step, so the batch spans frames
+    static constexpr size_t batch = 64;
+    ord::persistent queue[batch];
+    size_t head = 0, queued = 0;
+
+    // written every save_interval while running, if set
+    std::string ckpt;
+    static constexpr auto save_interval = std::chrono::seconds (10);
 
     std::thread t;
     std::condition_variable_any cv;
     std::atomic<bool> state = false;
     std::atomic<bool> stopped = false;
+    // the enumeration ran out; the thread waits for a seek to go on
+    std::atomic<bool> ended = false;
 
  public:
-    animation (size_t ums, std::vector<size_t>&& wt) {
+    animation (size_t ums, std::vector<size_t>&& wt, std::string path, const std::optional<ord::checkpoint>& from): ckpt (std::move (path)) {
         bound = wt.size () - 1;
+        size_t ut0 = 0;
+        if (from.has_value ()) {
+            o = ord::persistent (from->o);
+            steps = from->steps;
+            ut0 = from->ut;
+        }
+        shown = std::make_shared<const ord::persistent> (o);
+
+        t = std::thread ([this, ums, ut0, wt = std::move (wt)] {
+            auto saved = std::chrono::steady_clock::now ();
 
-        t = std::thread ([this, ums, wt = std::move (wt)] {
-            for (size_t ut = 0;;) {
+            for (size_t ut = ut0;;) {
                 std::unique_lock l (m);
-                cv.wait (l, [this] () -> bool { return state; });
+                cv.wait (l, [this] () -> bool { return stopped || (state && !ended); });
                 if (stopped) break;
 
                 while (ut < ums) {
-                    if (!o.to_next (bound)) {
-                        stopped = true;
-                        break;
+                    if (head == queued) {
+                        auto next = o;
+                        head = 0;
+                        queued = next.to_next (bound, std::span (queue));
+                        if (!queued) {
+                            ended = true;
+                            break;
+                        }
                     }
+
+                    o = queue[head++];
+                    ++steps;
                     ut += wt[bound - o.complexity ()];
                 }
 
+                shown = std::make_shared<const ord::persistent> (o);
+                auto snap = o;
+                auto snap_steps = steps;
                 l.unlock ();
                 std::this_thread::sleep_for (std::chrono::milliseconds (ut / ums * 10));
                 ut %= ums;
+
+                if (ckpt.size () && std::chrono::steady_clock::now () - saved >= save_interval) {
+                    if (!ord::save_checkpoint (ckpt, {snap.value (), bound, snap_steps, ut}))
+                        std::cerr << "failed to write checkpoint " << ckpt << std::endl;
+                    saved = std::chrono::steady_clock::now ();
+                }
             }
         });
     }
@@ -52,13 +99,27 @@ class animation {
 
     void pause () { state = false; }
 
-    std::optional<std::string> get () {
-        if (stopped) return {};
+    bool seek (const ord::ordinal& target) {
+        ord::ordinal res;
+        if (!res.seek (target, bound)) return false;
 
+        // the steps to the new position are unknown, so the count restarts
         std::unique_lock l (m);
-        auto complex = o.complexity ();
-        auto stdf = o.std ();
-        l.unlock ();
+        o = ord::persistent (res);
+        head = queued = 0;
+        steps = 0;
+        shown = std::make_shared<const ord::persistent> (o);
+        ended = false;
+        cv.notify_one ();
+        return true;
+    }
+
+    std::optional<std::string> get () {
+        if (ended) return {};
+
+        auto snap = shown.load ();
+        auto complex = snap->complexity ();
+        auto stdf = snap->value ().std ();
 
         static const std::string clrs[] = {"Violet",      "Blue",      "Navy",   "RoyalBlue",   "Teal",
                                            "ForestGreen", "OliveDrab", "Sienna", "SaddleBrown", "Maroon"};
@@ -71,12 +132,31 @@ class animation {
 
     ~animation () {
         stopped = true;
+        cv.notify_one ();
 
         if (t.joinable ()) t.join ();
     }
 };
 
 int main (int argc, char** argv) {
+    // --checkpoint=<file> saves the enumeration periodically, and with
+    // --resume the run continues from that file
+    std::string ckpt;
+    bool resume = false;
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg.starts_with ("--checkpoint=")) {
+            ckpt = arg.substr (13);
+        } else if (arg == "--resume") {
+            resume = true;
+        } else {
+            args.push_back (argv[i]);
+        }
+    }
+    argc = args.size ();
+    argv = args.data ();
+
     size_t port = 1584, ums = 10;
     std::vector<size_t> wait_time = {10, 12, 15, 22, 30, 50, 80, 120, 200, 300, 500, 800, 1200, 2000, 3000, 5000};
 
@@ -93,6 +173,15 @@ int main (int argc, char** argv) {
         return 0;
     }
 
+    std::optional<ord::checkpoint> from;
+    if (resume) {
+        from = ord::load_checkpoint (ckpt);
+        if (!from.has_value () || from->bound != wait_time.size () - 1) {
+            std::cerr << "cannot resume from checkpoint '" << ckpt << "'" << std::endl;
+            return 0;
+        }
+    }
+
     std::ifstream findex ("index.html");
     if (!findex) {
         std::cerr << "index.html not found" << std::endl;
@@ -102,7 +191,7 @@ int main (int argc, char** argv) {
     ss << findex.rdbuf ();
     std::string index = ss.str ();
 
-    animation a (ums, std::move (wait_time));
+    animation a (ums, std::move (wait_time), ckpt, from);
 
     httplib::Server svr;
 
@@ -129,6 +218,33 @@ int main (int argc, char** argv) {
         res.status = 204;
     });
 
+    // /control/seek?to=p0(p0(0)) or /control/seek?latex=\omega
+    svr.Get ("/control/seek", [&] (const httplib::Request& req, httplib::Response& res) {
+        // longer targets only buy clients parse time; the parser caps nesting
+        constexpr size_t max_target = 4096;
+
+        bool latex = req.has_param ("latex");
+        auto text = req.get_param_value (latex ? "latex" : "to");
+        if (text.size () > max_target) {
+            res.status = 413;
+            res.set_content ("target longer than " + std::to_string (max_target) + " bytes", "text/plain");
+            return;
+        }
+
+        ord::parse_error err;
+        auto target = latex ? ord::parse_latex (text, err) : ord::parse (text, err);
+
+        if (!target.has_value ()) {
+            res.status = 400;
+            res.set_content (std::string (err.what) + " at " + std::to_string (err.pos), "text/plain");
+        } else if (!a.seek (target.value ())) {
+            res.status = 404;
+            res.set_content ("no ordinal within the bound", "text/plain");
+        } else {
+            res.status = 204;
+        }
+    });
+
     std::cout << "ord listening to port " << port << std::endl;
     svr.listen ("0.0.0.0", port);
 
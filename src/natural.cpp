@@ -0,0 +1,118 @@
+#include "natural.h"
+
+#include <bit>
+#include <iomanip>
+
+namespace ord {
+
+natural::natural (uint64_t x) {
+    if (x) limbs.push_back (x);
+}
+
+std::optional<uint64_t> natural::word () const {
+    if (limbs.size () > 1) return {};
+    return limbs.size () ? limbs[0] : 0;
+}
+
+size_t natural::bits () const {
+    if (limbs.empty ()) return 0;
+    return limbs.size () * 64 - std::countl_zero (limbs.back ());
+}
+
+size_t natural::hash () const {
+    uint64_t res = 0xcbf29ce484222325ull;
+    for (auto l : limbs) {
+        res ^= l;
+        res *= 0x100000001b3ull;
+    }
+
+    return res;
+}
+
+natural& natural::operator+= (uint64_t x) {
+    for (size_t i = 0; x; ++i) {
+        if (i == limbs.size ()) {
+            limbs.push_back (x);
+            break;
+        }
+        limbs[i] += x;
+        x = limbs[i] < x;
+    }
+
+    return *this;
+}
+
+natural& natural::operator*= (uint64_t x) {
+    if (!x) {
+        limbs.clear ();
+        return *this;
+    }
+
+    unsigned __int128 carry = 0;
+    for (auto& l : limbs) {
+        carry += static_cast<unsigned __int128> (l) * x;
+        l = static_cast<uint64_t> (carry);
+        carry >>= 64;
+    }
+    if (carry) limbs.push_back (static_cast<uint64_t> (carry));
+
+    return *this;
+}
+
+natural& natural::operator<<= (size_t n) {
+    if (limbs.empty ()) return *this;
+
+    auto words = n / 64;
+    auto shift = n % 64;
+    if (shift) {
+        uint64_t carry = 0;
+        for (auto& l : limbs) {
+            auto next = l >> (64 - shift);
+            l = l << shift | carry;
+            carry = next;
+        }
+        if (carry) limbs.push_back (carry);
+    }
+    limbs.insert (limbs.begin (), words, 0);
+
+    return *this;
+}
+
+std::strong_ordering natural::operator<=> (const natural& o) const {
+    if (auto cmp = limbs.size () <=> o.limbs.size (); cmp != 0) return cmp;
+
+    for (auto i = limbs.size (); i-- > 0;) {
+        if (auto cmp = limbs[i] <=> o.limbs[i]; cmp != 0) return cmp;
+    }
+
+    return std::strong_ordering::equal;
+}
+
+std::ostream& operator<< (std::ostream& os, const natural& x) {
+    // peel off 19 decimal digits at a time, lowest first
+    constexpr uint64_t chunk = 10000000000000000000ull;
+
+    auto rest = x.limbs;
+    std::vector<uint64_t> digits;
+    while (rest.size ()) {
+        unsigned __int128 r = 0;
+        for (auto i = rest.size (); i-- > 0;) {
+            r = r << 64 | rest[i];
+            rest[i] = static_cast<uint64_t> (r / chunk);
+            r %= chunk;
+        }
+        while (rest.size () && !rest.back ()) rest.pop_back ();
+        digits.push_back (static_cast<uint64_t> (r));
+    }
+
+    if (digits.empty ()) return os << '0';
+
+    auto fill = os.fill ('0');
+    os << digits.back ();
+    for (auto i = digits.size () - 1; i-- > 0;) os << std::setw (19) << digits[i];
+    os.fill (fill);
+
+    return os;
+}
+
+}  // namespace ord
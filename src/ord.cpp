@@ -1,16 +1,218 @@
 #include "ord.h"
 
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "memo.h"
+#include "stats.h"
 
 namespace ord {
 
-ordinal::ordinal (): terms (0) {}
-ordinal::ordinal (size_t n) {
-    if (n) {
-        terms = std::vector<cterm> (1, {{zero, zero}, n});
-    } else {
-        terms = std::vector<cterm> (0);
+namespace {
+
+size_t hash_combine (size_t h, size_t x) {
+    x *= 0x9e3779b97f4a7c15ull;
+    x ^= x >> 32;
+    return h ^ (x + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
+}
+
+// results of a const step keyed on (receiver, argument), kept while a
+// memo_scope lives on the thread. Terms are interned, so comparing keys
+// compares node pointers and counts only. Each table is direct-mapped: a
+// colliding entry is overwritten, which bounds its size and needs no lock.
+class memo_table {
+ public:
+    virtual void clear () = 0;
+
+ protected:
+    ~memo_table () = default;
+};
+
+// kept trivial so that the check on every tpsi and boost is a plain load
+struct memo_state {
+    size_t scopes = 0;
+    memo_stats stats = {};
+};
+
+thread_local memo_state memo_local;
+thread_local std::vector<memo_table*> memo_tables;
+
+template <class R>
+class memo final : public memo_table {
+    static constexpr size_t size = 1 << 12;
+
+    struct entry {
+        size_t h;
+        ordinal self, arg;
+        std::optional<R> res;
+    };
+
+    std::vector<entry> entries;
+
+ public:
+    memo () { memo_tables.push_back (this); }
+
+    void clear () override { std::vector<entry> ().swap (entries); }
+
+    [[nodiscard]]
+    static size_t key (const ordinal& self, const ordinal& arg) {
+        return hash_combine (self.hash (), arg.hash ());
+    }
+
+    [[nodiscard]]
+    const R* find (size_t h, const ordinal& self, const ordinal& arg) const {
+        ++memo_local.stats.lookups;
+        if (entries.empty ()) return nullptr;
+
+        const auto& e = entries[h & (size - 1)];
+        if (!e.res.has_value () || e.h != h || e.self != self || e.arg != arg) return nullptr;
+
+        ++memo_local.stats.hits;
+        return &e.res.value ();
+    }
+
+    const R& put (size_t h, const ordinal& self, const ordinal& arg, R&& res) {
+        if (entries.empty ()) entries.resize (size);
+
+        auto& e = entries[h & (size - 1)];
+        if (e.res.has_value ()) ++memo_local.stats.evictions;
+
+        e.h = h;
+        e.self = self;
+        e.arg = arg;
+        e.res = std::move (res);
+
+        return e.res.value ();
+    }
+};
+
+memo<std::optional<ordinal>>& boost_memo () {
+    thread_local memo<std::optional<ordinal>> res;
+    return res;
+}
+
+}  // namespace
+
+struct ordinal::term::node {
+    struct shard {
+        std::mutex m;
+        std::vector<node*> buckets;
+        size_t size = 0;
+
+        [[nodiscard]]
+        node*& bucket (size_t);
+        void rehash ();
+    };
+
+    static constexpr size_t nshards = 64;
+
+    ordinal id, v;
+    size_t hash, cx;
+    std::atomic<size_t> refs;
+    node* next;
+
+    [[nodiscard]]
+    static shard& shard_of (size_t);
+    template <class I, class V>
+    [[nodiscard]]
+    static node* intern (I&&, V&&);
+
+    void retain ();
+    void release ();
+
+    [[nodiscard]]
+    static void* operator new (size_t);
+    static void operator delete (void*, size_t);
+};
+
+ordinal::term::node*& ordinal::term::node::shard::bucket (size_t h) {
+    return buckets[(h / nshards) & (buckets.size () - 1)];
+}
+
+void ordinal::term::node::shard::rehash () {
+    std::vector<node*> old (buckets.size () * 2, nullptr);
+    std::swap (old, buckets);
+
+    for (auto* p : old) {
+        while (p) {
+            auto* next = p->next;
+            auto& head = bucket (p->hash);
+            p->next = head;
+            head = p;
+            p = next;
+        }
+    }
+}
+
+ordinal::term::node::shard& ordinal::term::node::shard_of (size_t h) {
+    // never destroyed: static ordinals may release their nodes during exit
+    static auto* shards = new shard[nshards];
+    return shards[h % nshards];
+}
+
+template <class I, class V>
+ordinal::term::node* ordinal::term::node::intern (I&& id, V&& v) {
+    auto h = hash_combine (id.hash (), v.hash ());
+    auto& s = shard_of (h);
+
+    std::lock_guard l (s.m);
+    if (s.buckets.empty ()) s.buckets.resize (nshards);
+
+    for (auto* p = s.bucket (h); p; p = p->next) {
+        if (p->hash != h || p->id != id || p->v != v) continue;
+
+        // a node whose count already dropped to zero is being unlinked by
+        // its last owner and must not be resurrected
+        auto r = p->refs.load (std::memory_order_relaxed);
+        while (r && !p->refs.compare_exchange_weak (r, r + 1, std::memory_order_relaxed)) {}
+        if (r) return p;
+    }
+
+    auto& head = s.bucket (h);
+    auto cx = std::max (id.complexity (), v.complexity ());
+    head = new node{std::forward<I> (id), std::forward<V> (v), h, cx, 1, head};
+    auto* res = head;
+    if (++s.size > s.buckets.size ()) s.rehash ();
+
+    return res;
+}
+
+void* ordinal::term::node::operator new (size_t n) { return pool_allocate (n); }
+void ordinal::term::node::operator delete (void* p, size_t n) { pool_deallocate (p, n); }
+
+void ordinal::term::node::retain () { refs.fetch_add (1, std::memory_order_relaxed); }
+
+void ordinal::term::node::release () {
+    if (refs.fetch_sub (1, std::memory_order_acq_rel) != 1) return;
+
+    auto& s = shard_of (hash);
+    {
+        std::lock_guard l (s.m);
+        auto* p = &s.bucket (hash);
+        while (*p != this) p = &(*p)->next;
+        *p = next;
+        --s.size;
     }
+
+    delete this;
+}
+
+ordinal::ordinal (): terms (), cx (0) {}
+ordinal::ordinal (size_t n): cx (n) {
+    if (n) terms.push_back ({{zero, zero}, n});
+}
+
+ordinal::ordinal (ordinal&& o) noexcept: terms (std::move (o.terms)), cx (std::exchange (o.cx, 0)) {}
+
+ordinal& ordinal::operator= (ordinal&& o) noexcept {
+    terms = std::move (o.terms);
+    cx = std::exchange (o.cx, 0);
+
+    return *this;
 }
 
 ordinal::operator bool () const { return !terms.empty (); }
@@ -18,21 +220,38 @@ ordinal::operator bool () const { return !terms.empty (); }
 bool ordinal::operator== (const ordinal& o) const { return terms == o.terms; }
 
 std::strong_ordering ordinal::operator<=> (const ordinal& o) const {
-    auto l = terms.size ();
-    auto ol = o.terms.size ();
+    // interned terms are equal exactly when they share a node, so the first
+    // differing term decides: the comparison moves into its ids, or into its
+    // vs if the ids turn out equal, and never has to come back up
+    const auto* a = this;
+    const auto* b = &o;
+    const ordinal* va = nullptr;
+    const ordinal* vb = nullptr;
+
+    while (true) {
+        auto l = a->terms.size ();
+        auto ol = b->terms.size ();
+        auto n = std::min (l, ol);
 
-    for (size_t i = 0; i < std::min (l, ol); ++i) {
-        const auto& [t, c] = terms[i];
-        const auto& [ot, oc] = o.terms[i];
+        size_t i = 0;
+        while (i < n && a->terms[i] == b->terms[i]) ++i;
 
-        if (auto cmp = t <=> ot; cmp != 0) {
-            return cmp;
-        } else if (auto cmp = c <=> oc; cmp != 0) {
-            return cmp;
+        if (i == n) {
+            if (l != ol || !va) return l <=> ol;
+            a = std::exchange (va, nullptr);
+            b = vb;
+            continue;
         }
-    }
 
-    return l <=> ol;
+        const auto& [t, c] = a->terms[i];
+        const auto& [ot, oc] = b->terms[i];
+        if (t == ot) return c <=> oc;
+
+        a = &t.id ();
+        b = &ot.id ();
+        va = &t.v ();
+        vb = &ot.v ();
+    }
 }
 
 ordinal ordinal::operator+ (const ordinal& o) const {
@@ -46,18 +265,18 @@ ordinal ordinal::operator+ (const ordinal& o) const {
 
     ordinal res;
     for (size_t i = 0; i < rtn - 1; ++i) {
-        res.terms.push_back (terms[i]);
+        res.push (terms[i]);
     }
 
     if (terms[rtn - 1].t == olt) {
-        res.terms.emplace_back (o.terms[0].t, terms[rtn - 1].c + o.terms[0].c);
+        res.push ({o.terms[0].t, terms[rtn - 1].c + o.terms[0].c});
     } else {
-        res.terms.push_back (terms[rtn - 1]);
-        res.terms.push_back (o.terms[0]);
+        res.push (terms[rtn - 1]);
+        res.push (o.terms[0]);
     }
 
     for (size_t i = 1; i < o.terms.size (); ++i) {
-        res.terms.push_back (o.terms[i]);
+        res.push (o.terms[i]);
     }
 
     return res;
@@ -74,18 +293,18 @@ ordinal ordinal::operator+ (ordinal&& o) const {
 
     ordinal res;
     for (size_t i = 0; i < rtn - 1; ++i) {
-        res.terms.push_back (terms[i]);
+        res.push (terms[i]);
     }
 
     if (terms[rtn - 1].t == olt) {
-        res.terms.emplace_back (std::move (o.terms[0].t), terms[rtn - 1].c + o.terms[0].c);
+        res.push ({std::move (o.terms[0].t), terms[rtn - 1].c + o.terms[0].c});
     } else {
-        res.terms.push_back (terms[rtn - 1]);
-        res.terms.push_back (std::move (o.terms[0]));
+        res.push (terms[rtn - 1]);
+        res.push (std::move (o.terms[0]));
     }
 
     for (size_t i = 1; i < o.terms.size (); ++i) {
-        res.terms.push_back (std::move (o.terms[i]));
+        res.push (std::move (o.terms[i]));
     }
 
     return res;
@@ -94,18 +313,18 @@ ordinal ordinal::operator+ (ordinal&& o) const {
 ordinal& ordinal::operator+= (const ordinal& o) {
     if (!o) return *this;
 
-    while (terms.size () && terms.back ().t < o.terms[0].t) terms.pop_back ();
+    while (terms.size () && terms.back ().t < o.terms[0].t) pop ();
 
     if (terms.size ()) {
         if (terms.back ().t == o.terms[0].t) {
-            terms.back ().c += o.terms[0].c;
+            bump (o.terms[0].c);
         } else {
-            terms.push_back (o.terms[0]);
+            push (o.terms[0]);
         }
 
-        for (size_t i = 1; i < o.terms.size (); ++i) terms.push_back (o.terms[i]);
+        for (size_t i = 1; i < o.terms.size (); ++i) push (o.terms[i]);
     } else {
-        terms = o.terms;
+        *this = o;
     }
 
     return *this;
@@ -114,18 +333,18 @@ ordinal& ordinal::operator+= (const ordinal& o) {
 ordinal& ordinal::operator+= (ordinal&& o) {
     if (!o) return *this;
 
-    while (terms.size () && terms.back ().t < o.terms[0].t) terms.pop_back ();
+    while (terms.size () && terms.back ().t < o.terms[0].t) pop ();
 
     if (terms.size ()) {
         if (terms.back ().t == o.terms[0].t) {
-            terms.back ().c += o.terms[0].c;
+            bump (o.terms[0].c);
         } else {
-            terms.push_back (std::move (o.terms[0]));
+            push (std::move (o.terms[0]));
         }
 
-        for (size_t i = 1; i < o.terms.size (); ++i) terms.push_back (std::move (o.terms[i]));
+        for (size_t i = 1; i < o.terms.size (); ++i) push (std::move (o.terms[i]));
     } else {
-        terms = std::move (o.terms);
+        *this = std::move (o);
     }
 
     return *this;
@@ -147,7 +366,7 @@ std::ostream& operator<< (std::ostream& os, const ordinal& o) {
 }
 
 std::ostream& operator<< (std::ostream& os, const ordinal::term& t) {
-    os << 'p' << t.id << '(' << t.v << ')';
+    os << 'p' << t.id () << '(' << t.v () << ')';
     return os;
 }
 
@@ -162,50 +381,256 @@ ordinal psi (const ordinal& v) {
 
 ordinal::stdform ordinal::std () const { return ordinal::stdform (*this); }
 
-size_t ordinal::complexity () const {
-    size_t res = 0;
-    for (const auto& [t, c] : terms) {
-        const auto& [id, v] = t;
-        res += std::max (id.complexity (), v.complexity ()) + c;
-    }
+size_t ordinal::complexity () const { return cx; }
+
+size_t ordinal::hash () const {
+    size_t res = terms.size ();
+    for (const auto& [t, c] : terms) res = hash_combine (hash_combine (res, t.hash ()), c);
 
     return res;
 }
 
 bool ordinal::to_next (size_t bound) {
     *this += one;
+
+    size_t n = 0;
+    auto ok = true;
+    for (; ok && complexity () > bound; ++n) ok = limit ();
+
+    if constexpr (stats_enabled) stats::to_next (n);
+    return ok;
+}
+
+size_t ordinal::to_next (size_t bound, std::span<ordinal> out) {
+    size_t n = 0;
+    for (; n < out.size () && to_next (bound); ++n) out[n] = *this;
+
+    return n;
+}
+
+size_t ordinal::to_next (size_t bound, std::span<size_t> out) {
+    size_t n = 0;
+    for (; n < out.size () && to_next (bound); ++n) out[n] = cx;
+
+    return n;
+}
+
+// limit () moves to the least ordinal above that can be simpler, so it never
+// skips an ordinal within the bound; to_next is seek from *this + 1
+bool ordinal::seek (const ordinal& target, size_t bound) {
+    *this = target;
     while (complexity () > bound)
         if (!limit ()) return false;
     return true;
 }
 
+// fundamental sequences after Buchholz, reading the term {id, v} as
+// psi_id (v), where psi_0 (0) is 1 and psi_id (0) is Omega_id. A v above
+// Omega_id has to bound its own subterms (see tpsi), so psi_id (v) keeps an
+// uncountable cofinality of v only while v <= Omega_id and otherwise
+// diagonalizes, even where Buchholz's C_id would pass it on.
+
+ordinal ordinal::dom () const {
+    // a sum has the dom of its last term, psi_id (0) with a limit id that of
+    // id, and psi_id (v) with a limit v that of v unless it diagonalizes
+    if (!*this) return zero;
+    if (successor ()) return one;
+
+    const auto* o = this;
+    auto fits = true;
+    while (true) {
+        const auto& t = o->terms.back ().t;
+        if (t.v ()) {
+            if (t.v ().successor ()) return omega;
+            fits = fits && t.v ().fits (t.id ());
+            o = &t.v ();
+        } else if (t.id ().successor ()) {
+            return fits ? psi (t.id (), zero) : omega;
+        } else {
+            o = &t.id ();
+        }
+    }
+}
+
+cofinality ordinal::cof () const {
+    auto d = dom ();
+    if (!d) return cofinality::zero;
+    if (d == one) return cofinality::successor;
+    if (d == omega) return cofinality::countable;
+
+    return cofinality::uncountable;
+}
+
+ordinal ordinal::fs (size_t n) const { return fs (ordinal (n)); }
+
+ordinal ordinal::fs (const ordinal& x) const {
+    // only one path changes: the last term, then its v, or its id when v is
+    // zero, down to a term whose sequence is immediate. The levels passed are
+    // rebuilt around the new bottom on the way back up. The nested calls of
+    // a diagonalizing level never diagonalize again, so they stay shallow.
+    struct level {
+        const ordinal* o;
+        bool in_v;
+    };
+    thread_local std::vector<level> path;
+    auto base = path.size ();
+
+    if (!*this) return zero;
+
+    const auto* o = this;
+    while (true) {
+        const auto& t = o->terms.back ().t;
+        if (t.v ()) {
+            if (t.v ().successor ()) break;
+            path.push_back ({o, true});
+            o = &t.v ();
+        } else {
+            if (!t.id () || t.id ().successor ()) break;
+            path.push_back ({o, false});
+            o = &t.id ();
+        }
+    }
+
+    auto single = [] (term&& t) {
+        ordinal res;
+        return res += std::move (t);
+    };
+
+    // x < omega wherever it counts steps
+    size_t n = x ? x.terms[0].c : 0;
+
+    // an Omega_{mu+1} at the bottom diagonalizes at the first level above
+    // whose v does not fit, if any
+    const auto& bt = o->terms.back ().t;
+    auto top = path.size ();
+    auto diagonal = false;
+    if (!bt.v () && bt.id ()) {
+        for (auto i = top; i-- > base;) {
+            const auto& t = path[i].o->terms.back ().t;
+            if (path[i].in_v && !t.v ().fits (t.id ())) {
+                top = i + 1;
+                diagonal = true;
+                break;
+            }
+        }
+    }
+
+    ordinal res;
+    if (diagonal) {
+        // psi_id (v)[n] is psi_id (v[g_n]) with g_0 = Omega_mu and
+        // g_{k+1} = psi_mu (v[g_k])
+        const auto& v = path[top - 1].o->terms.back ().t.v ();
+        auto mu = bt.id ().prefix ();
+
+        auto g = single ({mu, zero});
+        for (size_t k = 0; k < n; ++k) g = single ({mu, v.fs (g)});
+        res = v.fs (g);
+    } else if (!bt.v ()) {
+        // a successor, or Omega_id with a successor id
+        res = o->prefix ();
+        if (bt.id ()) res += x;
+    } else {
+        // psi_id (v + 1)[n] is psi_id (v) n
+        res = o->prefix ();
+        if (n) res.push ({{bt.id (), bt.v ().prefix ()}, n});
+    }
+
+    for (auto i = top; i-- > base;) {
+        const auto& [lo, in_v] = path[i];
+        const auto& t = lo->terms.back ().t;
+
+        auto r = lo->prefix ();
+        if (in_v) {
+            r += term (t.id (), std::move (res));
+        } else {
+            r += term (std::move (res), zero);
+        }
+        res = std::move (r);
+    }
+    path.resize (base);
+
+    return res;
+}
+
+bool ordinal::fits (const ordinal& id) const {
+    const auto& [t, c] = terms[0];
+    if (t.id () != id) return t.id () < id;
+
+    return !t.v () && c == 1 && terms.size () == 1;
+}
+
+bool ordinal::successor () const { return terms.size () && terms.back ().t == one.terms[0].t; }
+
+ordinal ordinal::prefix () const {
+    auto res = *this;
+    auto [t, c] = res.pop ();
+    if (c > 1) res.push ({std::move (t), c - 1});
+
+    return res;
+}
+
 ordinal& ordinal::operator+= (const term& t) {
-    while (terms.size () > 0 && terms.back ().t < t) terms.pop_back ();
+    while (terms.size () > 0 && terms.back ().t < t) pop ();
 
     if (terms.size () > 0 && terms.back ().t == t) {
-        ++terms.back ().c;
+        bump (1);
     } else {
-        terms.emplace_back (t, 1);
+        push ({t, 1});
     }
 
     return *this;
 }
 ordinal& ordinal::operator+= (term&& t) {
-    while (terms.size () > 0 && terms[terms.size () - 1].t < t) terms.pop_back ();
+    while (terms.size () > 0 && terms[terms.size () - 1].t < t) pop ();
 
     if (terms.size () > 0 && terms[terms.size () - 1].t == t) {
-        ++terms[terms.size () - 1].c;
+        bump (1);
     } else {
-        terms.emplace_back (std::move (t), 1);
+        push ({std::move (t), 1});
     }
 
     return *this;
 }
 
+void ordinal::push (const cterm& ct) {
+    cx += ct.t.complexity () + ct.c;
+    terms.push_back (ct);
+}
+void ordinal::push (cterm&& ct) {
+    cx += ct.t.complexity () + ct.c;
+    terms.push_back (std::move (ct));
+}
+
+ordinal::cterm ordinal::pop () {
+    auto ct = std::move (terms.back ());
+    terms.pop_back ();
+    cx -= ct.t.complexity () + ct.c;
+
+    return ct;
+}
+
+void ordinal::bump (size_t c) {
+    cx += c;
+    terms.back ().c += c;
+}
+
 ordinal::term ordinal::tpsi (const ordinal& v) const {
+    if constexpr (stats_enabled) stats::tpsi ();
+
     if (!v) return {*this, v};
-    if (v.terms[0].t.id < *this) return {*this, v};
+    if (v.terms[0].t.id () < *this) return {*this, v};
 
+    if (!memo_local.scopes) return collapse (v);
+
+    // only collapses are remembered; the cases above cost less than a lookup
+    thread_local memo<term> cache;
+    auto h = cache.key (*this, v);
+    if (const auto* res = cache.find (h, *this, v)) return *res;
+
+    return cache.put (h, *this, v, collapse (v));
+}
+
+ordinal::term ordinal::collapse (const ordinal& v) const {
     auto bv = v.boost (v);
     if (!bv.has_value ()) return {*this + one, zero};
 
@@ -213,49 +638,121 @@ ordinal::term ordinal::tpsi (const ordinal& v) const {
 }
 
 std::optional<ordinal> ordinal::boost (const ordinal& cv) const {
-    ordinal res;
+    // boost recurses into the id and then the v of each term, always with
+    // the same cv, so each pending call is a frame of an explicit stack. A
+    // tpsi on the way may boost again: the stack is shared per thread and
+    // every call only touches the frames above its base.
+    struct frame {
+        const ordinal* self;
+        size_t i;
+        bool in_v;
+        size_t h;
+        ordinal res;
+    };
+    thread_local std::vector<frame> st;
+    auto base = st.size ();
+
+    // the result of the call that returned last
+    std::optional<ordinal> ret;
+
+    // starts a call, returning true if it already finished
+    auto call = [&] (const ordinal& self) {
+        if constexpr (stats_enabled) stats::boost ();
+
+        if (!self) {
+            ret = zero;
+            return true;
+        }
 
-    for (const auto& [t, c] : terms) {
-        const auto& [id, v] = t;
+        size_t h = 0;
+        if (memo_local.scopes) {
+            h = boost_memo ().key (self, cv);
+            if (const auto* res = boost_memo ().find (h, self, cv)) {
+                ret = *res;
+                return true;
+            }
+        }
 
-        auto obid = id.boost (cv);
-        if (!obid.has_value ()) return {};
-        auto& bid = obid.value ();
+        st.push_back ({&self, 0, false, h, {}});
+        return false;
+    };
 
-        if (bid >= cv) return {};
-        if (bid > id) return res += bid.tpsi (zero);
+    auto finish = [&] (std::optional<ordinal>&& res) {
+        auto& f = st.back ();
+        if (memo_local.scopes) {
+            ret = boost_memo ().put (f.h, *f.self, cv, std::move (res));
+        } else {
+            ret = std::move (res);
+        }
+        st.pop_back ();
 
-        auto obv = v.boost (cv);
-        if (!obv.has_value ()) return res += (id + one).tpsi (zero);
-        auto& bv = obv.value ();
+        return true;
+    };
+
+    auto returned = call (*this);
+    while (st.size () > base) {
+        auto& f = st.back ();
 
-        if (bv >= cv) return res += (id + one).tpsi (zero);
-        if (bv > v) return res += id.tpsi (bv);
+        if (!returned) {
+            if (f.i == f.self->terms.size ()) {
+                returned = finish (std::move (f.res));
+            } else {
+                returned = call (f.self->terms[f.i].t.id ());
+            }
+            continue;
+        }
 
-        res.terms.emplace_back (t, c);
+        // f called a boost of the id or v of its term i, which gave ret
+        const auto& [t, c] = f.self->terms[f.i];
+        const auto& id = t.id ();
+        const auto& v = t.v ();
+
+        if (!f.in_v) {
+            if (!ret.has_value () || ret.value () >= cv) {
+                returned = finish ({});
+            } else if (ret.value () > id) {
+                auto bt = ret.value ().tpsi (zero);
+                returned = finish (std::move (st.back ().res += std::move (bt)));
+            } else {
+                f.in_v = true;
+                returned = call (v);
+            }
+        } else if (!ret.has_value () || ret.value () >= cv) {
+            auto bt = (id + one).tpsi (zero);
+            returned = finish (std::move (st.back ().res += std::move (bt)));
+        } else if (ret.value () > v) {
+            // may boost again, moving the frames
+            auto bt = id.tpsi (ret.value ());
+            returned = finish (std::move (st.back ().res += std::move (bt)));
+        } else {
+            f.res.push ({t, c});
+            ++f.i;
+            f.in_v = false;
+            returned = false;
+        }
     }
 
-    return res;
+    return ret;
 }
 
 bool ordinal::limit () {
+    if constexpr (stats_enabled) stats::limit ();
+
     if (terms.size ()) {
-        auto [lt, lc] = std::move (terms.back ());
-        terms.pop_back ();
+        auto [lt, lc] = pop ();
 
         if (lc > 1) {
-            lt.v += one;
-            *this += std::move (lt);
+            *this += term (lt.id (), lt.v () + one);
         } else {
             if (lt.limit ()) {
                 if (terms.size () && terms.back ().t <= lt) {
-                    ++terms.back ().c;
+                    bump (1);
                 } else {
                     *this += lt;
                 }
             } else {
                 if (terms.size ()) {
-                    ++terms.back ().c;
+                    bump (1);
                 } else {
                     return false;
                 }
@@ -268,28 +765,135 @@ bool ordinal::limit () {
     }
 }
 
+ordinal::term::term (const ordinal& id, const ordinal& v): n (node::intern (id, v)) {}
+ordinal::term::term (ordinal&& id, ordinal&& v): n (node::intern (std::move (id), std::move (v))) {}
+
+ordinal::term::term (const term& t) noexcept: n (t.n) { n->retain (); }
+ordinal::term::term (term&& t) noexcept: n (std::exchange (t.n, nullptr)) {}
+
+ordinal::term& ordinal::term::operator= (const term& t) noexcept {
+    t.n->retain ();
+    if (n) n->release ();
+    n = t.n;
+
+    return *this;
+}
+ordinal::term& ordinal::term::operator= (term&& t) noexcept {
+    std::swap (n, t.n);
+    return *this;
+}
+
+ordinal::term::~term () {
+    if (n) n->release ();
+}
+
+const ordinal& ordinal::term::id () const { return n->id; }
+const ordinal& ordinal::term::v () const { return n->v; }
+size_t ordinal::term::hash () const { return n->hash; }
+size_t ordinal::term::complexity () const { return n->cx; }
+
 bool ordinal::term::limit () {
-    if (v) {
-        if (v.limit ()) {
-            *this = id.tpsi (v);
-        } else {
-            id += one;
+    // term::limit and ordinal::limit call each other along a single path:
+    // a term limits its v, or its id when v is zero, which limits its last
+    // term, and so on. The path is walked down on an explicit stack, then
+    // every level is finished on the way up with the result of the one below.
+    struct frame {
+        ordinal id, v;
+        bool in_v;
+    };
+    thread_local std::vector<frame> st;
+    auto base = st.size ();
+
+    auto below = [&] () -> ordinal& {
+        auto& f = st.back ();
+        return f.in_v ? f.v : f.id;
+    };
+
+    if constexpr (stats_enabled) stats::term_limit_enter ();
+    st.emplace_back (id (), v (), bool (v ()));
+
+    auto res = false;
+    while (true) {
+        auto& o = below ();
+
+        if constexpr (stats_enabled) stats::limit ();
+        if (!o) break;
+
+        auto [lt, lc] = o.pop ();
+        if (lc > 1) {
+            o += term (lt.id (), lt.v () + one);
+            res = true;
+            break;
         }
-    } else {
-        return id.limit ();
+
+        // o continues once lt is limited
+        if constexpr (stats_enabled) stats::term_limit_enter ();
+        st.emplace_back (lt.id (), lt.v (), bool (lt.v ()));
     }
 
-    return true;
+    while (true) {
+        // tpsi never limits, so f stays in place
+        auto& f = st.back ();
+        std::optional<term> t;
+        if (f.in_v) {
+            if (res) {
+                t = f.id.tpsi (f.v);
+            } else {
+                f.id += one;
+                t = term (std::move (f.id), std::move (f.v));
+            }
+        } else if (res) {
+            t = term (std::move (f.id), std::move (f.v));
+        }
+
+        st.pop_back ();
+        if constexpr (stats_enabled) stats::term_limit_exit ();
+
+        if (st.size () == base) {
+            if (!t.has_value ()) return false;
+            *this = std::move (t.value ());
+            return true;
+        }
+
+        // back in the limit of the ordinal that popped f's term
+        auto& o = below ();
+        if (t.has_value ()) {
+            if (o.terms.size () && o.terms.back ().t <= t.value ()) {
+                o.bump (1);
+            } else {
+                o += std::move (t.value ());
+            }
+            res = true;
+        } else if (o.terms.size ()) {
+            o.bump (1);
+            res = true;
+        } else {
+            res = false;
+        }
+    }
 }
 
+bool ordinal::term::operator== (const ordinal::term& o) const { return n == o.n; }
+
 std::strong_ordering ordinal::term::operator<=> (const ordinal::term& o) const {
-    if (auto cmp = id <=> o.id; cmp != 0) {
+    if (n == o.n) {
+        return std::strong_ordering::equal;
+    } else if (auto cmp = n->id <=> o.n->id; cmp != 0) {
         return cmp;
     } else {
-        return v <=> o.v;
+        return n->v <=> o.n->v;
     }
 }
 
+memo_scope::memo_scope () { ++memo_local.scopes; }
+
+memo_scope::~memo_scope () {
+    if (--memo_local.scopes) return;
+    for (auto* t : memo_tables) t->clear ();
+}
+
+memo_stats thread_memo_stats () { return memo_local.stats; }
+
 const ordinal zero = ordinal ();
 const ordinal one = psi (zero);
 const ordinal omega = psi (one);
@@ -421,13 +1025,13 @@ std::strong_ordering ordinal::stdform::operator<=> (const ordinal::stdform& o) c
 ordinal::stdform::iterm::iterm (): mterms (), oe () {}
 
 ordinal::stdform::iterm::iterm (const term& t) {
-    const auto& [id, v] = t;
-    const auto& vterms = v.terms;
+    const auto& id = t.id ();
+    const auto& vterms = t.v ().terms;
 
     ordinal prim, add;
     size_t i;
-    for (i = 0; i < vterms.size () && vterms[i].t.id > id; ++i) prim.terms.push_back (vterms[i]);
-    for (; i < vterms.size (); ++i) add.terms.push_back (vterms[i]);
+    for (i = 0; i < vterms.size () && vterms[i].t.id () > id; ++i) prim.push (vterms[i]);
+    for (; i < vterms.size (); ++i) add.push (vterms[i]);
 
     if (id || prim) mterms.emplace_back (stdterm{id.std (), prim.std ()}, stdform ({{}, 1}));
 
@@ -0,0 +1,149 @@
+#include "packed.h"
+
+#include <utility>
+
+namespace ord {
+
+packed::packed (): words (1, end_token) {}
+
+packed::packed (const ordinal& o) {
+    struct frame {
+        const ordinal* o;
+        size_t i;
+        int stage;
+    };
+    std::vector<frame> st (1, {&o, 0, 0});
+
+    while (st.size ()) {
+        auto& [p, i, stage] = st.back ();
+
+        if (i == p->terms.size ()) {
+            words.push_back (end_token);
+            st.pop_back ();
+            continue;
+        }
+
+        const auto& [t, c] = p->terms[i];
+        if (stage == 0) {
+            words.push_back (term_token);
+            stage = 1;
+            st.push_back ({&t.id (), 0, 0});
+        } else if (stage == 1) {
+            stage = 2;
+            st.push_back ({&t.v (), 0, 0});
+        } else {
+            words.push_back (c);
+            stage = 0;
+            ++i;
+        }
+    }
+}
+
+ordinal packed::unpack () const {
+    // every open ordinal is either the top level or the id / v of a term of
+    // the frame below it; an ordinal frame with has_id set is waiting for v
+    struct frame {
+        ordinal o, id;
+        bool has_id;
+    };
+    std::vector<frame> st (1);
+
+    for (size_t i = 0; i < words.size (); ++i) {
+        if (words[i] == term_token) {
+            st.emplace_back ();
+            continue;
+        }
+
+        auto done = std::move (st.back ().o);
+        st.pop_back ();
+        if (st.empty ()) return done;
+
+        auto& parent = st.back ();
+        if (!parent.has_id) {
+            parent.id = std::move (done);
+            parent.has_id = true;
+            st.emplace_back ();
+        } else {
+            parent.o.push ({{std::move (parent.id), std::move (done)}, words[++i]});
+            parent.has_id = false;
+        }
+    }
+
+    return {};
+}
+
+std::optional<ordinal> packed::unpack (std::span<const uint64_t> words) {
+    // the frames of unpack () const, checking every step the trusted
+    // version takes for granted
+    struct frame {
+        ordinal o, id;
+        bool has_id;
+    };
+    std::vector<frame> st (1);
+
+    for (size_t i = 0; i < words.size (); ++i) {
+        if (words[i] == term_token) {
+            st.emplace_back ();
+            continue;
+        }
+        if (words[i] != end_token) return {};
+
+        auto done = std::move (st.back ().o);
+        st.pop_back ();
+        if (st.empty ()) {
+            if (i + 1 != words.size ()) return {};
+            return done;
+        }
+
+        auto& parent = st.back ();
+        if (!parent.has_id) {
+            parent.id = std::move (done);
+            parent.has_id = true;
+            st.emplace_back ();
+        } else {
+            if (++i == words.size () || !words[i]) return {};
+
+            ordinal::term t (std::move (parent.id), std::move (done));
+            if (t.id ().tpsi (t.v ()) != t) return {};
+            if (parent.o && !(t < parent.o.terms.back ().t)) return {};
+
+            parent.o.push ({std::move (t), words[i]});
+            parent.has_id = false;
+        }
+    }
+
+    return {};
+}
+
+const uint64_t* packed::data () const { return words.data (); }
+
+size_t packed::size () const { return words.size (); }
+
+size_t packed::hash () const {
+    uint64_t res = 0xcbf29ce484222325ull;
+    for (auto w : words) {
+        res ^= w;
+        res *= 0x100000001b3ull;
+    }
+
+    return res;
+}
+
+std::strong_ordering packed::operator<=> (const packed& o) const {
+    const auto* a = words.data ();
+    const auto* b = o.words.data ();
+    auto n = std::min (words.size (), o.words.size ());
+
+    // scan four words at a time; the branch-free inner test vectorizes
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if ((a[i] ^ b[i]) | (a[i + 1] ^ b[i + 1]) | (a[i + 2] ^ b[i + 2]) | (a[i + 3] ^ b[i + 3])) break;
+    }
+    for (; i < n; ++i) {
+        if (a[i] != b[i]) return a[i] <=> b[i];
+    }
+
+    return words.size () <=> o.words.size ();
+}
+
+}  // namespace ord
@@ -0,0 +1,126 @@
+#include "persistent.h"
+
+#include <vector>
+
+namespace ord {
+
+struct persistent::node {
+    cterm ct;
+    std::shared_ptr<const node> prev;
+    size_t cx;  // of the ordinal ending here
+};
+
+void persistent::push (const cterm& ct) {
+    auto cx = complexity () + ct.t.complexity () + ct.c;
+    last = std::allocate_shared<const node> (pool_allocator<node> (), ct, std::move (last), cx);
+}
+
+persistent::cterm persistent::pop () {
+    auto ct = last->ct;
+    last = last->prev;
+
+    return ct;
+}
+
+void persistent::bump (size_t c) {
+    auto ct = pop ();
+    ct.c += c;
+    push (ct);
+}
+
+persistent& persistent::operator+= (const term& t) {
+    while (last && last->ct.t < t) pop ();
+
+    if (last && last->ct.t == t) {
+        bump (1);
+    } else {
+        push ({t, 1});
+    }
+
+    return *this;
+}
+
+persistent::persistent (): last () {}
+
+persistent::persistent (const ordinal& o) {
+    for (const auto& ct : o.terms) push (ct);
+}
+
+ordinal persistent::value () const {
+    std::vector<const node*> path;
+    for (auto* p = last.get (); p; p = p->prev.get ()) path.push_back (p);
+
+    ordinal res;
+    for (auto it = path.rbegin (); it != path.rend (); ++it) res.push ((*it)->ct);
+
+    return res;
+}
+
+persistent persistent::operator+ (const ordinal& o) const {
+    auto res = *this;
+    return res += o;
+}
+
+persistent& persistent::operator+= (const ordinal& o) {
+    if (!o) return *this;
+
+    while (last && last->ct.t < o.terms[0].t) pop ();
+
+    if (last && last->ct.t == o.terms[0].t) {
+        bump (o.terms[0].c);
+    } else {
+        push (o.terms[0]);
+    }
+
+    for (size_t i = 1; i < o.terms.size (); ++i) push (o.terms[i]);
+
+    return *this;
+}
+
+size_t persistent::complexity () const { return last ? last->cx : 0; }
+
+// the same steps as ordinal::limit, which only ever touch the tail
+bool persistent::limit () {
+    if (!last) return false;
+
+    auto [lt, lc] = pop ();
+
+    if (lc > 1) {
+        *this += term (lt.id (), lt.v () + one);
+    } else if (lt.limit ()) {
+        if (last && last->ct.t <= lt) {
+            bump (1);
+        } else {
+            *this += lt;
+        }
+    } else if (last) {
+        bump (1);
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+bool persistent::to_next (size_t bound) {
+    *this += one;
+    while (complexity () > bound)
+        if (!limit ()) return false;
+    return true;
+}
+
+size_t persistent::to_next (size_t bound, std::span<persistent> out) {
+    size_t n = 0;
+    for (; n < out.size () && to_next (bound); ++n) out[n] = *this;
+
+    return n;
+}
+
+size_t persistent::to_next (size_t bound, std::span<size_t> out) {
+    size_t n = 0;
+    for (; n < out.size () && to_next (bound); ++n) out[n] = complexity ();
+
+    return n;
+}
+
+}  // namespace ord
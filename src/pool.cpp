@@ -0,0 +1,140 @@
+#include "pool.h"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+#include "stats.h"
+
+namespace ord {
+
+namespace {
+
+constexpr size_t granule = 16;
+constexpr size_t nclasses = 16;
+constexpr size_t chunk_size = 64 * 1024;
+
+struct block {
+    block* next;
+};
+
+// free lists left behind by threads that exited. stocked is read without
+// the lock, so that growing threads only lock when there is something to take
+struct depot {
+    std::mutex m;
+    block* lists[nclasses] = {};
+    std::atomic<bool> stocked[nclasses] = {};
+
+    void put (size_t cls, block* head) {
+        if (!head) return;
+
+        auto* tail = head;
+        while (tail->next) tail = tail->next;
+
+        std::lock_guard l (m);
+        tail->next = lists[cls];
+        lists[cls] = head;
+        stocked[cls].store (true, std::memory_order_release);
+    }
+
+    block* take (size_t cls) {
+        if (!stocked[cls].load (std::memory_order_acquire)) return nullptr;
+
+        std::lock_guard l (m);
+        auto* res = lists[cls];
+        lists[cls] = nullptr;
+        stocked[cls].store (false, std::memory_order_relaxed);
+
+        return res;
+    }
+};
+
+depot& global_depot () {
+    // never destroyed: blocks may be released while statics are torn down
+    static auto* d = new depot;
+    return *d;
+}
+
+struct cache {
+    block* free[nclasses] = {};
+    char* cur[nclasses] = {};
+    char* end[nclasses] = {};
+    pool_stats stats = {};
+    bool alive = true;
+
+    ~cache () {
+        alive = false;
+        for (size_t i = 0; i < nclasses; ++i) {
+            global_depot ().put (i, free[i]);
+            free[i] = nullptr;
+        }
+    }
+
+    void* allocate (size_t cls) {
+        // the own free list, then the current chunk, then a whole list from
+        // the depot, and only then a new chunk
+        auto size = (cls + 1) * granule;
+        if (!free[cls] && cur[cls] + size > end[cls]) free[cls] = global_depot ().take (cls);
+
+        if (auto* b = free[cls]) {
+            free[cls] = b->next;
+            return b;
+        }
+
+        if (cur[cls] + size > end[cls]) {
+            ++stats.system;
+            cur[cls] = static_cast<char*> (::operator new (chunk_size));
+            end[cls] = cur[cls] + chunk_size;
+        }
+
+        auto* res = cur[cls];
+        cur[cls] += size;
+
+        return res;
+    }
+
+    void deallocate (void* p, size_t cls) {
+        auto* b = static_cast<block*> (p);
+
+        if (alive) {
+            b->next = free[cls];
+            free[cls] = b;
+        } else {
+            b->next = nullptr;
+            global_depot ().put (cls, b);
+        }
+    }
+};
+
+thread_local cache local;
+
+}  // namespace
+
+pool_stats thread_pool_stats () { return local.stats; }
+
+void* pool_allocate (size_t n) {
+    ++local.stats.allocations;
+    if constexpr (stats_enabled) stats::allocation ();
+
+    if (n == 0) n = 1;
+    if (n > nclasses * granule) {
+        ++local.stats.system;
+        return ::operator new (n);
+    }
+
+    return local.allocate ((n - 1) / granule);
+}
+
+void pool_deallocate (void* p, size_t n) {
+    ++local.stats.deallocations;
+
+    if (n == 0) n = 1;
+    if (n > nclasses * granule) {
+        ::operator delete (p);
+        return;
+    }
+
+    local.deallocate (p, (n - 1) / granule);
+}
+
+}  // namespace ord
@@ -0,0 +1,121 @@
+#include "serial.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace ord {
+
+namespace {
+
+constexpr char magic[] = {'o', 'r', 'd', 'v'};
+
+}  // namespace
+
+encoder::encoder (std::ostream& os): sb (os.rdbuf ()) {
+    sb->sputn (magic, sizeof (magic));
+    put (version);
+}
+
+void encoder::put (uint64_t x) {
+    for (; x >= 0x80; x >>= 7) sb->sputc (static_cast<char> (x | 0x80));
+    sb->sputc (static_cast<char> (x));
+}
+
+void encoder::write (const ordinal& o) {
+    st.assign (1, {&o, 0, 0});
+    put (o.terms.size ());
+
+    while (st.size ()) {
+        auto& [p, i, stage] = st.back ();
+
+        if (i == p->terms.size ()) {
+            st.pop_back ();
+            continue;
+        }
+
+        const auto& [t, c] = p->terms[i];
+        const auto* next = stage == 0 ? &t.id () : stage == 1 ? &t.v () : nullptr;
+        if (next) {
+            ++stage;
+            put (next->terms.size ());
+            st.push_back ({next, 0, 0});
+        } else {
+            put (c);
+            stage = 0;
+            ++i;
+        }
+    }
+}
+
+decoder::decoder (std::istream& is): sb (is.rdbuf ()), bad (false) {
+    char head[sizeof (magic)];
+    uint64_t v;
+    if (sb->sgetn (head, sizeof (head)) != sizeof (head) || !std::equal (head, head + sizeof (head), magic) || !get (v) ||
+        v != encoder::version)
+        bad = true;
+}
+
+bool decoder::get (uint64_t& x) {
+    x = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        auto b = sb->sbumpc ();
+        if (b == std::streambuf::traits_type::eof ()) return false;
+
+        x |= static_cast<uint64_t> (b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+
+    return false;
+}
+
+std::nullopt_t decoder::fail () {
+    bad = true;
+    return std::nullopt;
+}
+
+std::optional<ordinal> decoder::read () {
+    if (bad) return {};
+    if (sb->sgetc () == std::streambuf::traits_type::eof ()) return {};
+
+    uint64_t n;
+    st.clear ();
+    if (!get (n)) return fail ();
+    st.push_back ({{}, {}, n, false});
+
+    while (true) {
+        if (st.back ().left) {
+            // the id of the next term
+            if (!get (n)) return fail ();
+            st.push_back ({{}, {}, n, false});
+            continue;
+        }
+
+        auto done = std::move (st.back ().o);
+        st.pop_back ();
+        if (st.empty ()) return done;
+
+        auto& parent = st.back ();
+        if (!parent.has_id) {
+            parent.id = std::move (done);
+            parent.has_id = true;
+            if (!get (n)) return fail ();
+            st.push_back ({{}, {}, n, false});
+            continue;
+        }
+
+        uint64_t c;
+        if (!get (c) || !c) return fail ();
+
+        ordinal::term t (std::move (parent.id), std::move (done));
+        if (t.id ().tpsi (t.v ()) != t) return fail ();
+        if (parent.o && !(t < parent.o.terms.back ().t)) return fail ();
+
+        parent.o.push ({std::move (t), c});
+        parent.has_id = false;
+        --parent.left;
+    }
+}
+
+bool decoder::failed () const { return bad; }
+
+}  // namespace ord
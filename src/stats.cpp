@@ -0,0 +1,134 @@
+#include "stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace ord {
+
+namespace {
+
+// written by its own thread only, read by any; the relaxed load and store
+// pair keeps that race-free without a locked increment
+struct block {
+    std::atomic<size_t> to_next, limit, term_limit, tpsi, boost, allocations;
+    std::atomic<size_t> limits_per_step[core_stats::buckets], term_limit_depth[core_stats::buckets];
+    size_t depth = 0;
+};
+
+void bump (std::atomic<size_t>& c) { c.store (c.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+void bump (std::atomic<size_t> (&h)[core_stats::buckets], size_t i) { bump (h[std::min (i, core_stats::buckets - 1)]); }
+
+void add (core_stats& s, const block& b) {
+    auto get = [] (const std::atomic<size_t>& c) { return c.load (std::memory_order_relaxed); };
+
+    s.to_next += get (b.to_next);
+    s.limit += get (b.limit);
+    s.term_limit += get (b.term_limit);
+    s.tpsi += get (b.tpsi);
+    s.boost += get (b.boost);
+    s.allocations += get (b.allocations);
+    for (size_t i = 0; i < core_stats::buckets; ++i) {
+        s.limits_per_step[i] += get (b.limits_per_step[i]);
+        s.term_limit_depth[i] += get (b.term_limit_depth[i]);
+    }
+}
+
+struct registry {
+    std::mutex m;
+    std::vector<const block*> live;
+    core_stats finished = {};
+};
+
+registry& global_registry () {
+    // never destroyed: threads may finish while statics are torn down
+    static auto* r = new registry;
+    return *r;
+}
+
+struct local_block : block {
+    local_block () {
+        auto& r = global_registry ();
+        std::lock_guard l (r.m);
+        r.live.push_back (this);
+    }
+
+    ~local_block () {
+        auto& r = global_registry ();
+        std::lock_guard l (r.m);
+        add (r.finished, *this);
+        r.live.erase (std::find (r.live.begin (), r.live.end (), this));
+    }
+};
+
+thread_local local_block local;
+
+// the main thread's counters are merged before statics are destroyed
+struct dumper {
+    ~dumper () {
+        if (stats_enabled && std::getenv ("ORD_STATS_DUMP")) std::cerr << all_core_stats ();
+    }
+} dump_at_exit;
+
+}  // namespace
+
+core_stats thread_core_stats () {
+    core_stats res = {};
+    add (res, local);
+
+    return res;
+}
+
+core_stats all_core_stats () {
+    auto& r = global_registry ();
+    std::lock_guard l (r.m);
+
+    auto res = r.finished;
+    for (const auto* b : r.live) add (res, *b);
+
+    return res;
+}
+
+std::ostream& operator<< (std::ostream& os, const core_stats& s) {
+    os << "to_next " << s.to_next << "\nlimit " << s.limit << "\nterm::limit " << s.term_limit << "\ntpsi " << s.tpsi
+       << "\nboost " << s.boost << "\npool allocations " << s.allocations;
+
+    auto histogram = [&] (const char* name, const size_t (&h)[core_stats::buckets], size_t from) {
+        os << '\n' << name;
+        for (size_t i = 0; i < core_stats::buckets; ++i) {
+            if (!h[i]) continue;
+            os << ' ' << i + from << (i + 1 == core_stats::buckets ? "+:" : ":") << h[i];
+        }
+    };
+    histogram ("limit per to_next", s.limits_per_step, 0);
+    histogram ("term::limit depth", s.term_limit_depth, 1);
+
+    return os << std::endl;
+}
+
+namespace stats {
+
+void to_next (size_t limits) {
+    bump (local.to_next);
+    bump (local.limits_per_step, limits);
+}
+
+void limit () { bump (local.limit); }
+void tpsi () { bump (local.tpsi); }
+void boost () { bump (local.boost); }
+void allocation () { bump (local.allocations); }
+
+void term_limit_enter () {
+    bump (local.term_limit);
+    bump (local.term_limit_depth, local.depth++);
+}
+
+void term_limit_exit () { --local.depth; }
+
+}  // namespace stats
+
+}  // namespace ord
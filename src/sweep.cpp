@@ -0,0 +1,39 @@
+#include "sweep.h"
+
+#include <algorithm>
+
+namespace ord {
+
+std::vector<ordinal> cut_points (size_t bound, size_t max_cuts) {
+    std::vector<ordinal> res (1, zero);
+    if (!bound) return res;
+
+    // the finest complete level below bound that still fits half the cuts
+    size_t fine = 0;
+    for (size_t b = 1; b < bound; ++b) {
+        std::vector<ordinal> level (1, zero);
+        for (ordinal o; level.size () <= max_cuts / 2 && o.to_next (b);) level.push_back (o);
+
+        if (level.size () > max_cuts / 2) break;
+        res = std::move (level);
+        fine = b;
+    }
+
+    // no level below bound has points above its own largest ordinal, yet
+    // from bound 3 on about two thirds of the enumeration lies there, mostly
+    // psi_x (v) with x of complexity < bound. Those are split by leading id,
+    // at Omega_x for x running through the level below bound if it is
+    // complete, or else through the cut points of that bound, which split
+    // its own top the same way. The ids get every cut the level left, so
+    // each step of the recursion down from a large bound still gets a
+    // complete level.
+    auto ids = fine + 1 == bound ? res : cut_points (bound - 1, max_cuts - res.size ());
+    for (const auto& x : ids) res.push_back (psi (x, zero));
+
+    std::sort (res.begin (), res.end ());
+    res.erase (std::unique (res.begin (), res.end ()), res.end ());
+
+    return res;
+}
+
+}  // namespace ord
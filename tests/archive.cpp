@@ -0,0 +1,90 @@
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "archive.h"
+#include "ord.h"
+
+// test_archive
+// checks an archive of the start of an enumeration against the run that
+// wrote it: at () and seek () return every step, lower_bound () finds every
+// ordinal of the run and the place of those of the run one bound up, and a
+// file whose writes failed does not open
+
+using ord::archive;
+using ord::archive_writer;
+using ord::ordinal;
+
+namespace {
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, size_t interval, const ordinal& o) {
+    if (ok) return;
+
+    if (++failures <= 10) std::cerr << what << " at interval " << interval << ": " << o << std::endl;
+}
+
+void sweep (const std::string& path, size_t bound, size_t steps, size_t interval) {
+    std::vector<ordinal> seq;
+    ordinal o;
+    do {
+        seq.push_back (o);
+    } while (seq.size () < steps && o.to_next (bound));
+
+    {
+        archive_writer w (path, bound, interval);
+        for (const auto& x : seq) w.write (x);
+        check (w.finish (), "finish", interval, seq.back ());
+    }
+
+    archive a (path);
+    check (a.good () && a.bound () == bound && a.size () == seq.size (), "header", interval, seq.back ());
+    if (!a.good ()) return;
+
+    for (size_t i = 0; i < seq.size (); ++i) {
+        check (a.at (i) == seq[i], "at", interval, seq[i]);
+        check (a.lower_bound (seq[i]) == i, "lower_bound", interval, seq[i]);
+    }
+    check (!a.at (seq.size ()), "at (size)", interval, seq.back ());
+
+    auto c = a.seek (seq.size () / 3);
+    for (auto i = seq.size () / 3; i < seq.size (); ++i) check (c.next () == seq[i], "seek", interval, seq[i]);
+    check (!c.next () && !a.seek (seq.size ()).next (), "seek past the end", interval, seq.back ());
+
+    // the start of the run one bound up falls between the steps: before the
+    // first one not below each ordinal
+    size_t first = 0, n = 0;
+    o = ord::zero;
+    do {
+        while (first < seq.size () && seq[first] < o) ++first;
+        check (a.lower_bound (o) == first, "lower_bound between", interval, o);
+    } while (++n < steps && o.to_next (bound + 1));
+}
+
+}  // namespace
+
+int main () {
+    auto path = (std::filesystem::temp_directory_path () / "test_archive.ord").string ();
+    for (size_t interval : {1, 16, 256}) sweep (path, 6, 3000, interval);
+
+    check (!archive (path + ".missing").good (), "missing file", 0, ord::zero);
+    if (std::filesystem::exists ("/dev/full")) {
+        archive_writer w ("/dev/full", 4, 16);
+        ordinal o;
+        do {
+            w.write (o);
+        } while (o.to_next (4));
+        check (!w.finish (), "finish on a full disk", 16, o);
+    }
+    std::filesystem::remove (path);
+
+    if (failures) {
+        std::cerr << failures << " failures" << std::endl;
+        return 1;
+    }
+    std::cout << "the archive finds every step and ordinal of its run" << std::endl;
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <cstddef>
+#include <iostream>
+#include <limits>
+
+#include "count.h"
+#include "ord.h"
+
+// test_count
+// checks counter against a walk of the enumeration: below () is the index
+// of every ordinal within the bound and the index of the next one for those
+// just past it, at () inverts it, and total () is the length of the walk;
+// rank and unrank agree with it and refuse the bounds make () refuses
+
+using ord::counter;
+using ord::ordinal;
+
+namespace {
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, size_t bound, const ordinal& o) {
+    if (ok) return;
+
+    if (++failures <= 10) std::cerr << what << " at bound " << bound << ": " << o << std::endl;
+}
+
+// targets are taken from the enumeration at `walk`, which can be above
+// bound; only the first `limit` of them for the large bounds
+void sweep (size_t bound, size_t walk, size_t limit = std::numeric_limits<size_t>::max ()) {
+    auto c = counter::make (bound);
+
+    size_t index = 0, n = 0;
+    ordinal o;
+    do {
+        check (c->below (o) == index, "below", bound, o);
+        if (o.complexity () <= bound) {
+            check (c->at (index) == o, "at", bound, o);
+            check (ord::rank (o, bound) == index && ord::unrank (index, bound) == o, "rank", bound, o);
+            ++index;
+        }
+    } while (++n < limit && o.to_next (walk));
+
+    if (n < limit) {
+        check (c->total () == index, "total", bound, o);
+        check (!c->at (index), "at (total)", bound, o);
+    }
+}
+
+}  // namespace
+
+int main () {
+    for (size_t bound = 0; bound < 4; ++bound) sweep (bound, bound + 1);
+    sweep (4, 4);
+    sweep (4, 5, 100000);
+    sweep (5, 5, 100000);
+
+    auto past = counter::max_bound + 1;
+    check (!counter::make (past), "make", past, ord::zero);
+    check (!ord::rank (ord::zero, past) && !ord::unrank (0, past), "rank", past, ord::zero);
+
+    if (failures) {
+        std::cerr << failures << " differences" << std::endl;
+        return 1;
+    }
+    std::cout << "counts match the enumeration" << std::endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "delta.h"
+#include "ord.h"
+
+// test_delta
+// checks that delta_reader reads back what delta_writer writes, for the start
+// of the enumerations at several keyframe intervals; that seek lands on every
+// step, forwards and back; and that a seek out of range or into a file
+// without its index fails and leaves the reader where it was
+
+using ord::delta_reader;
+using ord::delta_writer;
+using ord::ordinal;
+
+namespace {
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, size_t bound, size_t interval, size_t i) {
+    if (ok) return;
+
+    if (++failures <= 10) std::cerr << what << " at bound " << bound << ", interval " << interval << ", step " << i << std::endl;
+}
+
+void round_trip (size_t bound, size_t steps, size_t interval) {
+    std::vector<ordinal> seq;
+    ordinal o;
+    do {
+        seq.push_back (o);
+    } while (seq.size () < steps && o.to_next (bound));
+
+    std::stringstream s;
+    std::string unfinished;
+    {
+        delta_writer w (s, interval);
+        for (const auto& x : seq) w.write (x);
+        unfinished = s.str ();
+        check (w.finish (), "finish", bound, interval, seq.size ());
+    }
+
+    delta_reader r (s);
+    for (size_t i = 0; i < seq.size (); ++i) check (r.read () == seq[i], "read", bound, interval, i);
+    check (!r.read () && !r.failed (), "end", bound, interval, seq.size ());
+
+    // backwards from the end, so that every seek but the first goes back
+    for (auto i = seq.size (); i--;) {
+        check (r.seek (i) && r.read () == seq[i], "seek", bound, interval, i);
+        if (i + 1 < seq.size ()) check (r.read () == seq[i + 1], "read after seek", bound, interval, i);
+    }
+
+    check (r.seek (seq.size () / 2), "seek", bound, interval, seq.size () / 2);
+    check (!r.seek (seq.size ()), "seek past the end", bound, interval, seq.size ());
+    check (r.read () == seq[seq.size () / 2] && !r.failed (), "read after failed seek", bound, interval, seq.size () / 2);
+
+    std::stringstream u (unfinished);
+    delta_reader ru (u);
+    check (ru.read () == seq[0], "unfinished read", bound, interval, 0);
+    check (!ru.seek (0) && ru.read () == seq[1], "unfinished seek", bound, interval, 1);
+}
+
+}  // namespace
+
+int main () {
+    for (size_t interval : {1, 7, 64}) {
+        round_trip (4, 3000, interval);
+        round_trip (8, 3000, interval);
+        round_trip (12, 3000, interval);
+    }
+
+    if (failures) {
+        std::cerr << failures << " failures" << std::endl;
+        return 1;
+    }
+    std::cout << "delta files round trip and seek to every step" << std::endl;
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <cstddef>
+#include <iostream>
+#include <ranges>
+#include <vector>
+
+#include "enumeration.h"
+#include "ord.h"
+
+// test_enumeration
+// checks the enumeration view against a walk of to_next: the whole view, the
+// views started at every ordinal of the walk one bound up, which start at the
+// least ordinal within the bound that is not below it, and a filter and take
+// pipeline over it
+
+using ord::enumeration;
+using ord::ordinal;
+
+namespace {
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, size_t bound, const ordinal& o) {
+    if (ok) return;
+
+    if (++failures <= 10) std::cerr << what << " at bound " << bound << ": " << o << std::endl;
+}
+
+std::vector<ordinal> walk (size_t bound) {
+    std::vector<ordinal> res;
+    ordinal o;
+    do {
+        res.push_back (o);
+    } while (o.to_next (bound));
+    return res;
+}
+
+void sweep (size_t bound) {
+    auto expected = walk (bound);
+
+    size_t i = 0;
+    for (const auto& o : enumeration (bound)) {
+        check (i < expected.size () && o == expected[i], "view", bound, o);
+        ++i;
+    }
+    check (i == expected.size (), "view length", bound, ord::zero);
+
+    // from every ordinal one bound up, the rest of the walk from the first
+    // ordinal that is not below it
+    size_t first = 0;
+    for (const auto& from : walk (bound + 1)) {
+        while (first < expected.size () && expected[first] < from) ++first;
+
+        i = first;
+        for (const auto& o : enumeration (bound, from)) {
+            check (i < expected.size () && o == expected[i], "view from", bound, from);
+            if (++i > expected.size ()) break;
+        }
+        check (i == expected.size (), "view from length", bound, from);
+    }
+
+    std::vector<ordinal> top;
+    for (const auto& o : expected)
+        if (o.complexity () == bound && top.size () < 5) top.push_back (o);
+
+    auto at_bound = [bound] (const ordinal& o) { return o.complexity () == bound; };
+    i = 0;
+    for (const auto& o : enumeration (bound) | std::views::filter (at_bound) | std::views::take (5)) {
+        check (i < top.size () && o == top[i], "pipeline", bound, o);
+        ++i;
+    }
+    check (i == top.size (), "pipeline length", bound, ord::zero);
+}
+
+}  // namespace
+
+int main () {
+    for (size_t bound = 0; bound < 4; ++bound) sweep (bound);
+
+    if (failures) {
+        std::cerr << failures << " differences" << std::endl;
+        return 1;
+    }
+    std::cout << "the enumeration view matches to_next" << std::endl;
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include <pthread.h>
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "ord.h"
+
+// test_equivalence
+// checks the iterative comparison, term::limit and boost of the core
+// against the recursive versions they replaced, on the start of every
+// enumeration, on random ordinals nested 10-300 deep, and on a psi chain
+// 5000 deep that the iterative versions must handle on a 256 KB stack
+
+namespace ord {
+
+// the recursive core as it was before the explicit stacks
+struct reference {
+    static std::strong_ordering compare (const ordinal& a, const ordinal& b) {
+        auto l = std::min (a.terms.size (), b.terms.size ());
+        for (size_t i = 0; i < l; ++i) {
+            if (auto cmp = compare (a.terms[i].t, b.terms[i].t); cmp != 0) return cmp;
+            if (auto cmp = a.terms[i].c <=> b.terms[i].c; cmp != 0) return cmp;
+        }
+
+        return a.terms.size () <=> b.terms.size ();
+    }
+
+    static std::strong_ordering compare (const ordinal::term& a, const ordinal::term& b) {
+        if (a == b) return std::strong_ordering::equal;
+        if (auto cmp = compare (a.id (), b.id ()); cmp != 0) return cmp;
+
+        return compare (a.v (), b.v ());
+    }
+
+    static bool less (const ordinal& a, const ordinal& b) { return compare (a, b) < 0; }
+
+    static ordinal::term tpsi (const ordinal& id, const ordinal& v) {
+        if (!v || less (v.terms[0].t.id (), id)) return {id, v};
+
+        auto bv = boost (v, v);
+        if (!bv.has_value ()) return {id + one, zero};
+
+        return {id, bv.value ()};
+    }
+
+    static std::optional<ordinal> boost (const ordinal& o, const ordinal& cv) {
+        ordinal res;
+
+        for (const auto& [t, c] : o.terms) {
+            const auto& id = t.id ();
+            const auto& v = t.v ();
+
+            auto bid = boost (id, cv);
+            if (!bid.has_value () || !less (bid.value (), cv)) return {};
+            if (less (id, bid.value ())) return res += tpsi (bid.value (), zero);
+
+            auto bv = boost (v, cv);
+            if (!bv.has_value () || !less (bv.value (), cv)) return res += tpsi (id + one, zero);
+            if (less (v, bv.value ())) return res += tpsi (id, bv.value ());
+
+            res.push ({t, c});
+        }
+
+        return res;
+    }
+
+    static bool limit (ordinal& o) {
+        if (o.terms.empty ()) return false;
+
+        auto [lt, lc] = o.pop ();
+        if (lc > 1) {
+            o += ordinal::term (lt.id (), lt.v () + one);
+        } else if (limit (lt)) {
+            if (o.terms.size () && compare (o.terms.back ().t, lt) <= 0) {
+                o.bump (1);
+            } else {
+                o += lt;
+            }
+        } else if (o.terms.size ()) {
+            o.bump (1);
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool limit (ordinal::term& t) {
+        auto id = t.id ();
+        auto v = t.v ();
+
+        if (v) {
+            if (limit (v)) {
+                t = tpsi (id, v);
+            } else {
+                id += one;
+                t = {std::move (id), std::move (v)};
+            }
+        } else {
+            if (!limit (id)) return false;
+            t = {std::move (id), std::move (v)};
+        }
+
+        return true;
+    }
+
+    // psi_0 (v), which is in normal form for v = psi_0 (...), without the
+    // collapse that psi would run down the whole of v
+    static ordinal nest (const ordinal& v) {
+        ordinal res;
+        res.push ({ordinal::term (ord::zero, v), 1});
+
+        return res;
+    }
+
+    // the iterative versions
+    static std::optional<ordinal> boost_of (const ordinal& o, const ordinal& cv) { return o.boost (cv); }
+    static ordinal::term tpsi_of (const ordinal& id, const ordinal& v) { return id.tpsi (v); }
+    static bool limit_of (ordinal& o) { return o.limit (); }
+};
+
+}  // namespace ord
+
+namespace {
+
+using ord::ordinal;
+using ref = ord::reference;
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, const ordinal& a, const ordinal& b) {
+    if (ok) return;
+    if (++failures <= 10) std::cerr << what << " differs for " << a << " and " << b << std::endl;
+}
+
+// every operation on a and b, each way
+void compare (const ordinal& a, const ordinal& b) {
+    check ((a <=> b) == ref::compare (a, b), "comparison", a, b);
+    check (ref::boost_of (a, b) == ref::boost (a, b), "boost", a, b);
+    check (ref::tpsi_of (a, b) == ref::tpsi (a, b), "tpsi", a, b);
+
+    auto x = a, y = a;
+    for (size_t i = 0; i < 4; ++i) {
+        auto more = ref::limit_of (x);
+        check (more == ref::limit (y) && x == y, "limit", a, b);
+        if (!more) break;
+    }
+}
+
+// runs f on a thread with the given stack size
+void on_stack (size_t size, const std::function<void ()>& f) {
+    pthread_attr_t attr;
+    pthread_attr_init (&attr);
+    pthread_attr_setstacksize (&attr, size);
+
+    pthread_t t;
+    auto run = [] (void* p) -> void* {
+        (*static_cast<const std::function<void ()>*> (p)) ();
+        return nullptr;
+    };
+    pthread_create (&t, &attr, run, const_cast<std::function<void ()>*> (&f));
+    pthread_join (t, nullptr);
+    pthread_attr_destroy (&attr);
+}
+
+}  // namespace
+
+int main () {
+    // the start of every enumeration, neighbours against each other
+    for (size_t bound = 1; bound <= 16; ++bound) {
+        ordinal o, prev;
+        for (size_t i = 0; i < 2000 && o.to_next (bound); ++i) {
+            compare (o, prev);
+            compare (prev, o);
+            prev = o;
+        }
+    }
+
+    // random ordinals nested 10-300 deep, each level collapsing a sum of
+    // the level below and a smaller piece
+    std::mt19937_64 rng (1);
+    std::vector<ordinal> small;
+    for (ordinal o; small.size () < 500 && o.to_next (6);) small.push_back (o);
+
+    std::vector<ordinal> deep;
+    for (size_t k = 0; k < 60; ++k) {
+        auto depth = 10 + rng () % 291;
+        ordinal o = small[rng () % small.size ()];
+        for (size_t d = 0; d < depth; ++d) {
+            const ordinal ids[] = {ord::zero, ord::one, ordinal (2), ord::omega};
+            o = ord::psi (ids[rng () % 4], o + small[rng () % small.size ()]);
+            if (rng () % 4 == 0) o += small[rng () % small.size ()];
+        }
+        deep.push_back (o);
+    }
+    for (size_t i = 0; i < deep.size (); ++i) {
+        for (size_t j = 0; j < deep.size (); ++j) compare (deep[i], deep[j]);
+        for (size_t j = 0; j < 20; ++j) {
+            const auto& s = small[rng () % small.size ()];
+            compare (deep[i], s);
+            compare (s, deep[i]);
+        }
+    }
+
+    // a chain 5000 deep: the iterative versions on a 256 KB stack, the
+    // recursive ones on a stack big enough for them
+    ordinal chain, shorter;
+    for (size_t i = 0; i < 5000; ++i) {
+        shorter = chain;
+        chain = ref::nest (chain);
+    }
+
+    std::optional<ordinal> boosted, ref_boosted;
+    ordinal limited = chain, ref_limited = chain;
+    std::strong_ordering cmp = std::strong_ordering::equal, ref_cmp = cmp;
+    on_stack (256 << 10, [&] {
+        boosted = ref::boost_of (chain, chain);
+        ref::limit_of (limited);
+        cmp = shorter <=> chain;
+    });
+    on_stack (size_t (1) << 30, [&] {
+        ref_boosted = ref::boost (chain, chain);
+        ref::limit (ref_limited);
+        ref_cmp = ref::compare (shorter, chain);
+    });
+    check (boosted == ref_boosted, "boost (chain)", chain, chain);
+    check (limited == ref_limited, "limit (chain)", chain, chain);
+    check (cmp == ref_cmp && cmp < 0, "comparison (chain)", shorter, chain);
+    check (ref::nest (ord::one) == ord::psi (ord::one), "nest", ord::one, ord::one);
+
+    if (failures) {
+        std::cerr << failures << " differences" << std::endl;
+        return 1;
+    }
+    std::cout << "iterative core matches the recursive versions" << std::endl;
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#include "ord.h"
+#include "packed.h"
+
+// test_fundamental
+// checks the fundamental sequences on the start of the enumerations: dom ()
+// and cof () agree, a successor's sequence is its predecessor, and the start
+// of every other sequence is in normal form, increasing and below the
+// ordinal; countable ones pass the ordinal's predecessor in the enumeration
+
+using ord::cofinality;
+using ord::ordinal;
+
+namespace {
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, size_t bound, const ordinal& o) {
+    if (ok) return;
+
+    if (++failures <= 10) std::cerr << what << " at bound " << bound << ": " << o << std::endl;
+}
+
+bool normal (const ordinal& x) {
+    ord::packed p (x);
+    return ord::packed::unpack (std::span (p.data (), p.size ())) == x;
+}
+
+// how far a countable sequence may take to pass the predecessor
+constexpr size_t reach = 64;
+
+void sweep (size_t bound, size_t steps, const std::vector<ordinal>& below) {
+    ordinal prev, o;
+    for (size_t n = 0; n < steps && o.to_next (bound); ++n, prev = o) {
+        auto d = o.dom ();
+        auto c = o.cof ();
+        check ((c == cofinality::successor) == (d == ord::one) && (c == cofinality::countable) == (d == ord::omega) &&
+                   (c == cofinality::uncountable) == (d > ord::omega),
+               "dom", bound, o);
+
+        if (c == cofinality::successor) {
+            check (o.fs (0) == prev, "successor", bound, o);
+            continue;
+        }
+
+        // the start of the sequence, and for a countable one as much more as
+        // it takes to pass the predecessor
+        ordinal last;
+        bool passed = false;
+        for (size_t i = 0; i < below.size (); ++i) {
+            auto x = c == cofinality::countable ? ordinal (i) : below[i];
+            if (x >= d) break;
+
+            auto y = o.fs (x);
+            check (normal (y) && y < o && (!i || y > last), "sequence", bound, o);
+            passed = passed || y > prev;
+            last = std::move (y);
+        }
+        for (auto i = below.size (); c == cofinality::countable && !passed && i < reach; ++i) passed = o.fs (i) > prev;
+        check (c != cofinality::countable || passed, "predecessor", bound, o);
+    }
+}
+
+}  // namespace
+
+int main () {
+    // arguments for uncountable sequences: the first ordinals of a small
+    // enumeration, 0 to 3 and then past omega
+    std::vector<ordinal> below;
+    ordinal x;
+    do {
+        below.push_back (x);
+    } while (below.size () < 8 && x.to_next (3));
+
+    for (size_t bound = 2; bound <= 8; ++bound) sweep (bound, 10000, below);
+
+    if (failures) {
+        std::cerr << failures << " failures" << std::endl;
+        return 1;
+    }
+    std::cout << "fundamental sequences are increasing, in normal form and below" << std::endl;
+    return 0;
+}
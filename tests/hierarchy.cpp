@@ -0,0 +1,121 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <optional>
+
+#include "hierarchy.h"
+#include "ord.h"
+
+// test_hierarchy
+// checks evaluator against known values of f and H, and against a plain
+// recursive evaluation of both on the start of an enumeration, wherever that
+// stays small; and that budgets and uncountable ordinals fail with a reason
+
+using ord::evaluator;
+using ord::natural;
+using ord::ordinal;
+
+namespace {
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, const ordinal& a, uint64_t x) {
+    if (ok) return;
+
+    if (++failures <= 10) std::cerr << what << " at " << a << ", " << x << std::endl;
+}
+
+// the definitions as they read, giving up past `cap` steps or values
+struct reference {
+    static constexpr uint64_t cap = 1 << 12;
+    size_t steps = 0;
+
+    std::optional<uint64_t> f (const ordinal& a, uint64_t x) {
+        if (++steps > cap || x > cap) return {};
+        if (!a) return x + 1;
+
+        if (a.cof () == ord::cofinality::successor) {
+            auto p = a.fs (0);
+            for (auto i = x; i--;) {
+                auto y = f (p, x);
+                if (!y.has_value ()) return {};
+                x = y.value ();
+            }
+            return x;
+        }
+        return f (a.fs (x), x);
+    }
+
+    std::optional<uint64_t> h (ordinal a, uint64_t x) {
+        for (; a; a = a.cof () == ord::cofinality::successor ? a.fs (0) : a.fs (x)) {
+            if (++steps > cap || x > cap) return {};
+            if (a.cof () == ord::cofinality::successor) ++x;
+        }
+        return x;
+    }
+};
+
+void known (bool hardy, const ordinal& a, uint64_t x, uint64_t value) {
+    evaluator e;
+    auto v = hardy ? e.hardy (a, x) : e.fast_growing (a, x);
+    check (v == natural (value), hardy ? "H" : "f", a, x);
+}
+
+}  // namespace
+
+int main () {
+    using ord::omega;
+    using ord::psi;
+
+    auto omega2 = psi (ord::zero, ordinal (2));
+    known (false, ord::zero, 5, 6);
+    known (false, ordinal (1), 5, 10);
+    known (false, ordinal (2), 3, 24);
+    known (false, ordinal (3), 2, 2048);
+    known (false, omega, 2, 8);
+    known (true, omega, 5, 10);
+    known (true, omega2, 3, 24);
+    known (true, omega2 + omega, 3, 384);
+
+    // every pair the reference can do among the first 400 ordinals at bound
+    // 8 below Omega, with fresh evaluators and with one kept warm
+    size_t compared = 0;
+    evaluator warm;
+    ordinal a;
+    size_t n = 0;
+    do {
+        if (a >= ord::Omega) continue;
+
+        for (uint64_t x = 0; x < 4; ++x) {
+            reference r;
+            if (auto v = r.f (a, x); v.has_value ()) {
+                check (evaluator ().fast_growing (a, x) == natural (v.value ()), "f reference", a, x);
+                check (warm.fast_growing (a, x) == natural (v.value ()), "f warm", a, x);
+                ++compared;
+            }
+
+            r.steps = 0;
+            if (auto v = r.h (a, x); v.has_value ()) {
+                check (evaluator ().hardy (a, x) == natural (v.value ()), "H reference", a, x);
+                check (warm.hardy (a, x) == natural (v.value ()), "H warm", a, x);
+                ++compared;
+            }
+        }
+    } while (++n < 400 && a.to_next (8));
+    check (compared >= 1000, "few pairs compared", a, compared);
+
+    evaluator limited (ord::eval_budget{.steps = 10});
+    auto a3 = psi (ord::zero, omega + ordinal (1));
+    check (!limited.fast_growing (a3, 3) && !std::strcmp (limited.error (), "step budget exhausted"), "step budget", a3, 3);
+    check (!limited.fast_growing (ord::Omega, 3) && !std::strcmp (limited.error (), "ordinal is not countable"), "uncountable", ord::Omega, 3);
+    check (!limited.hardy (ord::Omega, 3) && limited.error (), "uncountable", ord::Omega, 3);
+    check (limited.fast_growing (ord::zero, 3) == natural (4) && !limited.error (), "error cleared", ord::zero, 3);
+
+    if (failures) {
+        std::cerr << failures << " differences" << std::endl;
+        return 1;
+    }
+    std::cout << "f and H match the known values and the definitions" << std::endl;
+    return 0;
+}
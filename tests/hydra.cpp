@@ -0,0 +1,92 @@
+#include <cstddef>
+#include <iostream>
+
+#include "hydra.h"
+#include "ord.h"
+
+// test_hydra
+// checks the hydra game: the step counts of small hydras, that every hydra
+// from the start of an enumeration reads back as its ordinal and that each
+// step lowers it under all three strategies, and that max_nodes stops a game
+// before it is passed
+
+using ord::hydra;
+using ord::hydra_config;
+using ord::hydra_strategy;
+using ord::ordinal;
+
+namespace {
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, const ordinal& o) {
+    if (ok) return;
+
+    if (++failures <= 10) std::cerr << what << ": " << o << std::endl;
+}
+
+constexpr hydra_strategy strategies[] = {hydra_strategy::rightmost, hydra_strategy::leftmost, hydra_strategy::random};
+
+// the steps a hydra of o takes to die, 0 if it lives past limit
+uint64_t lifetime (const ordinal& o, hydra_strategy s, size_t limit = 1000000) {
+    auto h = hydra::from (o, {s, 1});
+    if (!h.has_value ()) return 0;
+
+    h->play (limit);
+    return h->dead () ? h->steps () : 0;
+}
+
+// plays up to limit steps one at a time; every one has to lower the value
+void descend (const ordinal& o, hydra_strategy s, size_t limit) {
+    auto h = hydra::from (o, {s, 7});
+    if (!h.has_value ()) return;
+
+    auto v = h->value ();
+    check (v == o, "value", o);
+    for (size_t n = 0; n < limit && !h->dead (); ++n) {
+        check (h->play (1) == 1 && h->steps () == n + 1, "step", o);
+
+        auto w = h->value ();
+        check (w < v, "descent", o);
+        v = std::move (w);
+    }
+    check (!h->dead () || (!v && !h->play (1)), "dead", o);
+}
+
+}  // namespace
+
+int main () {
+    using ord::omega;
+    using ord::psi;
+    using ord::zero;
+
+    auto omega_omega = psi (zero, omega);
+    check (lifetime (ordinal (1), hydra_strategy::rightmost) == 1, "1", ordinal (1));
+    check (lifetime (ordinal (3), hydra_strategy::rightmost) == 3, "3", ordinal (3));
+    for (auto s : strategies) check (lifetime (omega, s) == 3, "omega", omega);
+    check (lifetime (omega_omega, hydra_strategy::rightmost) == 37, "rightmost", omega_omega);
+    check (lifetime (omega_omega, hydra_strategy::leftmost) == 23, "leftmost", omega_omega);
+    check (lifetime (omega_omega, hydra_strategy::random) > 0, "random", omega_omega);
+
+    ordinal o;
+    size_t n = 0;
+    do {
+        for (auto s : strategies) descend (o, s, 20);
+    } while (++n < 300 && o.to_next (7));
+
+    // leftmost cuts soon grow omega^(omega 2) past a small max_nodes
+    auto big = psi (zero, omega + omega);
+    auto h = hydra::from (big, {hydra_strategy::leftmost, 0, 1000});
+    check (h.has_value () && h->play (1000000) < 1000000 && h->full () && !h->dead () && h->peak () <= 1000, "max_nodes", big);
+
+    check (!hydra::from (omega_omega, {hydra_strategy::rightmost, 0, 2}), "max_nodes at the start", omega_omega);
+    check (!hydra::from (psi (omega + ord::one, zero)), "label", psi (omega + ord::one, zero));
+    check (hydra::from (psi (omega, zero)).has_value (), "label omega", psi (omega, zero));
+
+    if (failures) {
+        std::cerr << failures << " failures" << std::endl;
+        return 1;
+    }
+    std::cout << "hydras die in the known steps and every step lowers them" << std::endl;
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "ord.h"
+#include "parse.h"
+
+// test_parse
+// checks that both readers read back what the printers write, for the start
+// of the enumerations, and that they refuse the other spellings of the same
+// ordinals at the position of the offending coefficient
+
+using ord::ordinal;
+
+namespace {
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, const std::string& s) {
+    if (ok) return;
+
+    if (++failures <= 10) std::cerr << what << ": " << s << std::endl;
+}
+
+template <class T>
+std::string text (const T& x) {
+    std::ostringstream os;
+    os << x;
+    return os.str ();
+}
+
+void refuse (const std::string& s, size_t pos, const char* what, bool latex) {
+    ord::parse_error err{};
+    auto o = latex ? ord::parse_latex (s, err) : ord::parse (s, err);
+    check (!o && err.pos == pos && !std::strcmp (err.what, what), what, s);
+}
+
+}  // namespace
+
+int main () {
+    for (size_t bound = 1; bound <= 8; ++bound) {
+        ordinal o;
+        for (size_t i = 0; i < 2000 && o.to_next (bound); ++i) {
+            auto s = text (o), l = text (o.std ());
+            check (ord::parse (s) == o, "text", s);
+            check (ord::parse_latex (l) == o, "latex", l);
+        }
+    }
+
+    refuse ("p0(0)1", 5, "coefficient 1 is implied", false);
+    refuse ("p0(0)007", 5, "leading zero", false);
+    refuse ("p0(0)0", 5, "coefficient must be positive", false);
+    refuse ("pp0(0)(0)2+p0(0)1", 16, "coefficient 1 is implied", false);
+    refuse ("\\omega1", 6, "coefficient 1 is implied", true);
+    refuse ("\\omega07", 6, "leading zero", true);
+    refuse ("\\omega+07", 7, "leading zero", true);
+    check (ord::parse ("p0(0)10") == ordinal (10), "text 10", "p0(0)10");
+    check (ord::parse_latex ("1") == ord::one, "latex 1", "1");
+
+    if (failures) {
+        std::cerr << failures << " failures" << std::endl;
+        return 1;
+    }
+    std::cout << "both readers read back what is printed, and only that" << std::endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "ord.h"
+#include "persistent.h"
+
+// test_persistent
+// checks persistent against ordinal along the start of the enumerations:
+// to_next, its batched forms and complexity give the same steps, sums agree,
+// and versions kept along the way still hold the values they had when later
+// versions were derived from them
+
+using ord::ordinal;
+using ord::persistent;
+
+namespace {
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, size_t bound, const ordinal& o) {
+    if (ok) return;
+
+    if (++failures <= 10) std::cerr << what << " at bound " << bound << ": " << o << std::endl;
+}
+
+void sweep (size_t bound, size_t steps) {
+    ordinal o;
+    persistent p;
+    std::vector<std::pair<persistent, ordinal>> kept;
+
+    for (size_t n = 0; n < steps; ++n) {
+        check (p.value () == o && p.complexity () == o.complexity (), "value", bound, o);
+        if (n % 97 == 0) kept.emplace_back (p, o);
+
+        // a sum derived from this version leaves it as it is
+        auto sum = p + o;
+        check (sum.value () == o + o, "sum", bound, o);
+
+        auto more = o.to_next (bound);
+        check (p.to_next (bound) == more, "to_next", bound, o);
+        if (!more) break;
+    }
+
+    for (const auto& [v, w] : kept) check (v.value () == w, "kept version", bound, w);
+
+    // the batched forms take the same steps
+    ordinal a, b;
+    persistent pa, pb;
+    std::array<ordinal, 64> os;
+    std::array<persistent, 64> ps;
+    std::array<size_t, 64> ac, pc;
+    for (size_t n = 0; n < steps;) {
+        auto k = a.to_next (bound, os);
+        check (pa.to_next (bound, ps) == k, "batch size", bound, a);
+        for (size_t i = 0; i < k; ++i) check (ps[i].value () == os[i], "batch", bound, os[i]);
+        check (pa.value () == a, "batch end", bound, a);
+
+        auto kc = b.to_next (bound, ac);
+        check (pb.to_next (bound, pc) == kc && std::equal (ac.begin (), ac.begin () + kc, pc.begin ()), "batch complexity", bound, b);
+
+        n += k;
+        if (k < os.size ()) break;
+    }
+}
+
+}  // namespace
+
+int main () {
+    for (size_t bound = 1; bound <= 8; ++bound) sweep (bound, 20000);
+
+    if (failures) {
+        std::cerr << failures << " differences" << std::endl;
+        return 1;
+    }
+    std::cout << "persistent ordinals match ordinal" << std::endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "ord.h"
+#include "serial.h"
+
+// test_serial
+// checks that decoder reads back what encoder writes, for the start of the
+// enumerations, and ends cleanly after it; that omega takes the bytes the
+// format gives for it; and that truncated or out-of-form input fails
+
+using ord::decoder;
+using ord::encoder;
+using ord::ordinal;
+
+namespace {
+
+size_t failures = 0;
+
+void check (bool ok, const char* what, const ordinal& o) {
+    if (ok) return;
+
+    if (++failures <= 10) std::cerr << what << ": " << o << std::endl;
+}
+
+void round_trip (size_t bound, size_t steps) {
+    std::stringstream s;
+    encoder e (s);
+    ordinal o;
+    size_t n = 0;
+    do {
+        e.write (o);
+    } while (++n < steps && o.to_next (bound));
+
+    decoder d (s);
+    o = ord::zero;
+    n = 0;
+    do {
+        auto r = d.read ();
+        check (r == o, "round trip", o);
+    } while (++n < steps && o.to_next (bound));
+
+    check (!d.read () && !d.failed (), "end of stream", o);
+}
+
+// whether decoding header and body hits an error
+bool fails (const std::string& body, const std::string& header = std::string ("ordv\x01", 5)) {
+    std::stringstream s (header + body);
+    decoder d (s);
+    while (d.read ()) {}
+    return d.failed ();
+}
+
+}  // namespace
+
+int main () {
+    for (size_t bound : {4, 8, 12}) round_trip (bound, 20000);
+
+    auto omega = ord::psi (ord::zero, ord::one);
+    std::ostringstream os;
+    encoder (os).write (omega);
+    const std::string bytes ("\x01\x00\x01\x00\x00\x01\x01", 7);
+    check (os.str () == "ordv\x01" + bytes, "bytes", omega);
+    check (!fails (bytes), "omega", omega);
+
+    for (size_t n = 1; n < bytes.size (); ++n) check (fails (bytes.substr (0, n)), "truncated", omega);
+    check (fails (bytes, "ordx\x01"), "magic", omega);
+    check (fails (bytes, std::string ("ordv\x02", 5)), "version", omega);
+    // a zero coefficient, and omega + omega written as two terms
+    check (fails (std::string ("\x01\x00\x01\x00\x00\x01\x00", 7)), "zero coefficient", omega);
+    check (fails (std::string ("\x02\x00\x01\x00\x00\x01\x01\x00\x01\x00\x00\x01\x01", 13)), "term order", omega);
+
+    if (failures) {
+        std::cerr << failures << " failures" << std::endl;
+        return 1;
+    }
+    std::cout << "the stream format round trips and refuses malformed input" << std::endl;
+    return 0;
+}
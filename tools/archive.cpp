@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "archive.h"
+#include "checkpoint.h"
+#include "ord.h"
+#include "parse.h"
+
+// ord_archive build <file> <bound> [steps] [interval] [--from=<checkpoint>]
+//     records a run of to_next from zero, or from a checkpoint of a live run
+// ord_archive at <file> <step> [count]
+// ord_archive find <file> <ordinal in p-notation>
+namespace {
+
+int usage () {
+    std::cerr << "usage: ord_archive build <file> <bound> [steps] [interval] [--from=<checkpoint>]\n"
+                 "       ord_archive at <file> <step> [count]\n"
+                 "       ord_archive find <file> <ordinal>"
+              << std::endl;
+    return 1;
+}
+
+int build (const std::string& path, size_t bound, size_t steps, size_t interval, const std::string& from) {
+    ord::ordinal o;
+    if (from.size ()) {
+        auto cp = ord::load_checkpoint (from);
+        if (!cp.has_value () || cp->bound != bound) {
+            std::cerr << "cannot start from checkpoint '" << from << "'" << std::endl;
+            return 1;
+        }
+        o = std::move (cp->o);
+    }
+
+    ord::archive_writer w (path, bound, interval);
+    size_t n = 0;
+    do {
+        w.write (o);
+    } while (++n < steps && o.to_next (bound));
+
+    if (!w.finish ()) {
+        std::cerr << "failed to write " << path << std::endl;
+        return 1;
+    }
+    std::cout << n << " ordinals written to " << path << std::endl;
+    return 0;
+}
+
+}  // namespace
+
+int main (int argc, char** argv) {
+    if (argc < 4) return usage ();
+
+    std::string cmd = argv[1], path = argv[2];
+
+    try {
+        if (cmd == "build") {
+            std::string from;
+            if (std::string last = argv[argc - 1]; last.starts_with ("--from=")) {
+                from = last.substr (7);
+                --argc;
+            }
+
+            auto bound = std::stoull (argv[3], nullptr, 10);
+            auto steps = argc > 4 ? std::stoull (argv[4], nullptr, 10) : SIZE_MAX;
+            auto interval = argc > 5 ? std::stoull (argv[5], nullptr, 10) : 1024;
+            return build (path, bound, steps, interval, from);
+        }
+
+        ord::archive a (path);
+        if (!a.good ()) {
+            std::cerr << "cannot open archive " << path << std::endl;
+            return 1;
+        }
+
+        if (cmd == "at") {
+            auto step = std::stoull (argv[3], nullptr, 10);
+            auto count = argc > 4 ? std::stoull (argv[4], nullptr, 10) : 1;
+
+            auto c = a.seek (step);
+            for (size_t i = 0; i < count; ++i) {
+                auto o = c.next ();
+                if (!o.has_value ()) break;
+                std::cout << step + i << ' ' << o.value () << '\n';
+            }
+            return 0;
+        }
+
+        if (cmd == "find") {
+            ord::parse_error err;
+            auto o = ord::parse (argv[3], err);
+            if (!o.has_value ()) {
+                std::cerr << err.what << " at " << err.pos << std::endl;
+                return 1;
+            }
+
+            auto step = a.lower_bound (o.value ());
+            if (step == a.size ()) {
+                std::cout << "past the end (" << a.size () << " ordinals)" << std::endl;
+            } else {
+                std::cout << step << ' ' << a.at (step).value () << std::endl;
+            }
+            return 0;
+        }
+    } catch (...) {
+        std::cerr << "invalid argument" << std::endl;
+        return 1;
+    }
+
+    return usage ();
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "hydra.h"
+#include "ord.h"
+#include "parse.h"
+
+// ord_hydra <ordinal> [rightmost|leftmost|random] [steps] [interval] [seed]
+//     plays the Buchholz hydra of an ordinal in p-notation, reporting the
+//     step count, live nodes and peak nodes every interval steps
+namespace {
+
+int usage () {
+    std::cerr << "usage: ord_hydra <ordinal> [rightmost|leftmost|random] [steps] [interval] [seed]" << std::endl;
+    return 1;
+}
+
+void report (const ord::hydra& h) {
+    std::cout << h.steps () << " steps, " << h.nodes () << " nodes, peak " << h.peak () << std::endl;
+}
+
+}  // namespace
+
+int main (int argc, char** argv) {
+    if (argc < 2) return usage ();
+
+    ord::parse_error err;
+    auto o = ord::parse (argv[1], err);
+    if (!o.has_value ()) {
+        std::cerr << err.what << " at " << err.pos << std::endl;
+        return 1;
+    }
+
+    ord::hydra_config config;
+    uint64_t steps = UINT64_MAX, interval = 1 << 24;
+    try {
+        if (argc > 2) {
+            std::string s = argv[2];
+            if (s == "rightmost")
+                config.strategy = ord::hydra_strategy::rightmost;
+            else if (s == "leftmost")
+                config.strategy = ord::hydra_strategy::leftmost;
+            else if (s == "random")
+                config.strategy = ord::hydra_strategy::random;
+            else
+                return usage ();
+        }
+        if (argc > 3) steps = std::stoull (argv[3], nullptr, 10);
+        if (argc > 4) interval = std::stoull (argv[4], nullptr, 10);
+        if (argc > 5) config.seed = std::stoull (argv[5], nullptr, 10);
+    } catch (...) {
+        std::cerr << "invalid argument" << std::endl;
+        return 1;
+    }
+    if (!interval) return usage ();
+
+    auto h = ord::hydra::from (o.value (), config);
+    if (!h.has_value ()) {
+        std::cerr << "no hydra: an id is not a natural or omega, or it has too many nodes" << std::endl;
+        return 1;
+    }
+
+    report (*h);
+    while (h->steps () < steps && !h->dead ()) {
+        h->play (std::min (interval, steps - h->steps ()));
+        report (*h);
+        if (h->full ()) {
+            std::cout << "stopped: the next step passes " << config.max_nodes << " nodes" << std::endl;
+            return 0;
+        }
+    }
+    if (h->dead ()) std::cout << "dead after " << h->steps () << " steps" << std::endl;
+
+    return 0;
+}